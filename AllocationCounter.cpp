@@ -0,0 +1,44 @@
+﻿
+#include "AllocationCounter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+	std::atomic<uint64> g_allocationCount{ 0 };
+
+	void* Allocate(std::size_t size) {
+		g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+		if (void* p = std::malloc(size ? size : 1)) {
+			return p;
+		}
+		throw std::bad_alloc{};
+	}
+
+	void* AllocateAligned(std::size_t size, std::align_val_t alignment) {
+		g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+		if (void* p = _aligned_malloc(size ? size : 1, static_cast<std::size_t>(alignment))) {
+			return p;
+		}
+		throw std::bad_alloc{};
+	}
+}
+
+uint64 AllocationCounter::Count() {
+	return g_allocationCount.load(std::memory_order_relaxed);
+}
+
+// nothrow 版は標準の実装がこれらを呼ぶので置き換えなくてよい
+void* operator new(std::size_t size) { return Allocate(size); }
+void* operator new[](std::size_t size) { return Allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { _aligned_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { _aligned_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { _aligned_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { _aligned_free(p); }
@@ -0,0 +1,9 @@
+﻿#pragma once
+# include "Common.hpp"
+
+// ヒープ確保の回数を数える
+// グローバルな operator new を置き換えるので、AllocationCounter.cpp はツール（DungeonWalkingTool）にだけ入れる
+namespace AllocationCounter {
+	// プロセス開始からの operator new の呼び出し回数（全スレッド合計）
+	uint64 Count();
+}
@@ -1,21 +1,25 @@
 ﻿#pragma once
 # include "Common.hpp"
+# include "OccupancyGrid.hpp"
+# include "Tile.hpp"
 
 class BasePlayer
 {
 public:
 	BasePlayer();
 
-	Point Move(int _x, int _y,Grid<int32>& mapData);
+	// 地形 mapData の上を動く（敵のいるマスへの移動は攻撃になり、その位置を返す）
+	Point Move(int _x, int _y, const TileGrid& mapData, OccupancyGrid& occupancy);
 
 	//攻撃
 	int Attack() { return Sterts.atc; };
 	//ダメージ
 	void Damage(int _damage) { Sterts.HP -= _damage; }
 
-	StertsBase GetSterts() { return Sterts; }
+	StertsBase GetSterts() const { return Sterts; }
+	void SetSterts(const StertsBase& _sterts) { Sterts = _sterts; }
 	void SetPlayerPos(Point _pos) { Player = _pos; }
-	Point GetPlayerPos() { return Player; }
+	Point GetPlayerPos() const { return Player; }
 
 	void draw() const;
 private:
@@ -12,3 +12,14 @@ void Camera::MoveCamera(int _PieceSize, int _WallThickness, Point _Player) {
 
 	CameraPos = pos - Point((800 - 150) / 2, (600 - 150) / 2);
 }
+
+Rect Camera::GetVisibleTiles(int _PieceSize, int _WallThickness, Size _ViewSize, Size _MapSize, int _Margin) const {
+	// マス x は [stride * x + 壁, stride * (x + 1)) のピクセルを占める
+	const double stride = _PieceSize + _WallThickness;
+	const int left = Max(static_cast<int>(std::floor(CameraPos.x / stride)) - _Margin, 0);
+	const int top = Max(static_cast<int>(std::floor(CameraPos.y / stride)) - _Margin, 0);
+	const int right = Min(static_cast<int>(std::floor((CameraPos.x + _ViewSize.x) / stride)) + _Margin + 1, _MapSize.x);
+	const int bottom = Min(static_cast<int>(std::floor((CameraPos.y + _ViewSize.y) / stride)) + _Margin + 1, _MapSize.y);
+
+	return Rect{ left, top, Max(right - left, 0), Max(bottom - top, 0) };
+}
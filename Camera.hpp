@@ -7,7 +7,11 @@ public:
 
 	void MoveCamera(int _PieceSize, int _WallThickness,Point _Player);
 
-	Point GetCamera() { return CameraPos; }
+	Point GetCamera() const { return CameraPos; }
+
+	// 画面（左上がカメラ位置、大きさ _ViewSize）に入るマスの範囲を返す
+	// 揺れや攻撃の踏み込みではみ出す分として周囲に _Margin マス広げ、マップ（_MapSize）の内側に収める
+	Rect GetVisibleTiles(int _PieceSize, int _WallThickness, Size _ViewSize, Size _MapSize, int _Margin = 1) const;
 
 private:
 	Point CameraPos = { 0,0 };
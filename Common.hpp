@@ -16,11 +16,30 @@ struct StertsBase {
 	ColorF color;
 };
 
+// マップの大きさ（フルマップの一辺 = ミニマップの一辺 × 部屋の一辺）
+struct MapConfig
+{
+	int32 miniSize = 5;   // ミニマップの一辺のマス数
+	int32 roomUnit = 10;  // ミニマップ1マスに対応する部屋の一辺
+
+	constexpr int32 mapSize() const { return miniSize * roomUnit; }
+
+	constexpr bool operator==(const MapConfig&) const = default;
+};
+
 // 共有するデータ
 struct GameData
 {
 	// レベル
 	int32 Lv = 0;
+	// フロアの大きさ（ストレステストやエンドゲームでは 1000x1000 まで広げる）
+	MapConfig FloorConfig;
+	// 1回のプレイのシード（各階のマップはこれと階層から決まる。0 ならゲーム開始時に決める）
+	uint64 RunSeed = 0;
+	// 現在の階（0 から数える）
+	int32 Stage = 0;
+	// プレイヤーのステータス（階をまたいで引き継ぐ）
+	StertsBase PlayerSterts = { U"",10,5,Palette::Blue };
 	// ハイスコア
 
 };
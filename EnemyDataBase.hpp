@@ -3,15 +3,16 @@
 
 
 
+// 敵の種類ごとのステータス表（読み取り専用で、全ての敵が共有する）
 class EnemyDataBase {
 public:
-	EnemyDataBase() {
+	static const StertsBase& Get(int32 id) { return EnemyData()[id]; }
 
-		EnemyData <<
+	static const Array<StertsBase>& EnemyData() {
+		static const Array<StertsBase> table{
 			StertsBase{ U"A",10,3,Palette::Red },
-			StertsBase{ U"B",10,3,Palette::Red };
-
+			StertsBase{ U"B",10,3,Palette::Red },
+		};
+		return table;
 	}
-
-	Array<StertsBase> EnemyData;
 };
@@ -0,0 +1,239 @@
+﻿
+#include "EnemyStore.hpp"
+
+void EnemyStore::clear() {
+	m_positions.clear();
+	m_hp.clear();
+	m_typeIds.clear();
+	m_states.clear();
+	m_chaseCounts.clear();
+	m_patrolIndices.clear();
+	m_patrolOrigins.clear();
+	m_traces.clear();
+	m_routes.clear();
+}
+
+void EnemyStore::reserve(size_t capacity) {
+	m_positions.reserve(capacity);
+	m_hp.reserve(capacity);
+	m_typeIds.reserve(capacity);
+	m_states.reserve(capacity);
+	m_chaseCounts.reserve(capacity);
+	m_patrolIndices.reserve(capacity);
+	m_patrolOrigins.reserve(capacity);
+	if constexpr (EnemySearchTrace::Enabled) {
+		m_traces.reserve(capacity);
+		m_routes.reserve(capacity);
+	}
+}
+
+size_t EnemyStore::spawn(Point pos, int32 typeId, OccupancyGrid& occupancy) {
+	m_positions << pos;
+	m_hp << EnemyDataBase::Get(typeId).HP;
+	m_typeIds << typeId;
+	m_states << EnemyState::IDLE;
+	m_chaseCounts << 0;
+	m_patrolIndices << 0;
+	m_patrolOrigins << pos;
+	if constexpr (EnemySearchTrace::Enabled) {
+		m_traces.emplace_back();
+		m_routes.emplace_back();
+	}
+	const size_t index = m_positions.size() - 1;
+	occupancy.placeEnemy(pos, index);
+	return index;
+}
+
+void EnemyStore::removeAt(size_t index, OccupancyGrid& occupancy) {
+	const size_t last = m_positions.size() - 1;
+	occupancy.removeEnemy(m_positions[index]);
+	if (index != last) {
+		occupancy.placeEnemy(m_positions[last], index);
+		m_positions[index] = m_positions[last];
+		m_hp[index] = m_hp[last];
+		m_typeIds[index] = m_typeIds[last];
+		m_states[index] = m_states[last];
+		m_chaseCounts[index] = m_chaseCounts[last];
+		m_patrolIndices[index] = m_patrolIndices[last];
+		m_patrolOrigins[index] = m_patrolOrigins[last];
+		if constexpr (EnemySearchTrace::Enabled) {
+			m_traces[index] = m_traces[last];
+			m_routes[index] = std::move(m_routes[last]);
+		}
+	}
+	m_positions.pop_back();
+	m_hp.pop_back();
+	m_typeIds.pop_back();
+	m_states.pop_back();
+	m_chaseCounts.pop_back();
+	m_patrolIndices.pop_back();
+	m_patrolOrigins.pop_back();
+	if constexpr (EnemySearchTrace::Enabled) {
+		m_traces.pop_back();
+		m_routes.pop_back();
+	}
+}
+
+void EnemyStore::removeDead(OccupancyGrid& occupancy) {
+	// 後ろから調べれば、入れ替わって来た敵も必ず調べ済みになる
+	for (size_t i = m_positions.size(); i-- > 0;) {
+		if (isDead(i)) {
+			removeAt(i, occupancy);
+		}
+	}
+}
+
+// 移動処理
+int32 EnemyStore::act(size_t index, Point player, const TileGrid& mapData, const VisibilityCache& visibility, OccupancyGrid& occupancy, const FlowField& playerField, PathFinder& pathFinder) {
+	const Point enemy = m_positions[index];
+	int dx = player.x - enemy.x;
+	int dy = player.y - enemy.y;
+	int distance = static_cast<int>(std::sqrt(dx * dx + dy * dy));
+
+	// 攻撃範囲にプレイヤーがいる → 攻撃状態
+	if (distance <= AttackRange) {
+		m_states[index] = EnemyState::ATTACK;
+		return status(index).atc;
+	}
+
+	// 索敵範囲内で見えている → 追跡開始（視界表のビットを引くだけ）
+	if (visibility.canSee(enemy, player)) {
+		m_states[index] = EnemyState::CHASE;
+		++m_chaseCounts[index];
+
+		// 一定時間追跡したら退避状態に移行
+		if (m_chaseCounts[index] > MaxChaseCount) {
+			m_states[index] = EnemyState::RETREAT;
+		}
+		else {
+			chase(index, occupancy, playerField);
+		}
+		return 0;
+	}
+	else {
+		// プレイヤーが見えなくなったら追跡カウンタをリセット
+		m_chaseCounts[index] = 0;
+	}
+
+	// 状態に応じた行動
+	switch (m_states[index]) {
+	case EnemyState::RETREAT:
+		retreat(index, mapData, occupancy, pathFinder);
+		break;
+	default:
+		m_states[index] = EnemyState::PATROL;
+		patrol(index, mapData, occupancy, pathFinder);
+		break;
+	}
+
+	return 0;
+}
+
+
+// プレイヤーを追いかける
+// 経路はプレイヤー移動時に1回だけ作られる距離マップから引くので、敵ごとのA*は不要
+void EnemyStore::chase(size_t index, OccupancyGrid& occupancy, const FlowField& playerField) {
+	const Point enemy = m_positions[index];
+	const auto next = playerField.nextStep(enemy, occupancy);
+
+	if constexpr (EnemySearchTrace::Enabled) {
+		m_traces[index].clear();
+		m_routes[index].clear();
+		if (next) {
+			m_routes[index] << enemy << *next;
+		}
+	}
+
+	if (next) {
+		stepTo(index, *next, occupancy);
+	}
+}
+
+// A*による経路探索（作業領域は全ての敵で共有するエンジンのものを使う）
+bool EnemyStore::searchRoute(size_t index, Point goal, const TileGrid& mapData, const OccupancyGrid& occupancy, PathFinder& pathFinder) {
+	if constexpr (EnemySearchTrace::Enabled) {
+		const bool found = pathFinder.findPath(m_positions[index], goal, mapData, occupancy, m_route, m_traces[index]);
+		m_routes[index] = m_route;
+		return found;
+	}
+	else {
+		return pathFinder.findPath(m_positions[index], goal, mapData, occupancy, m_route);
+	}
+}
+
+// 1マス進む（地形は書き換えず、占有情報だけを移す）
+void EnemyStore::stepTo(size_t index, Point next, OccupancyGrid& occupancy) {
+	occupancy.moveEnemy(m_positions[index], next);
+	m_positions[index] = next;
+}
+
+
+// 敵の描画（探索状況の可視化付き）
+void EnemyStore::draw(int pieceSize, int wallThickness, Point camera, const Rect& visibleTiles, const OccupancyGrid& occupancy, const FieldOfView& playerView) const {
+	const auto toScreen = [&](const Point& p) {
+		return Point{ (p.x * pieceSize) + (pieceSize / 2) + ((p.x + 1) * wallThickness) - camera.x,
+			(p.y * pieceSize) + (pieceSize / 2) + ((p.y + 1) * wallThickness) - camera.y };
+	};
+
+	// 探索の可視化はトレースが有効なビルドでだけ行う
+	if constexpr (EnemySearchTrace::Enabled) {
+		Array<Point> lineRoute;
+		for (size_t i = 0; i < m_positions.size(); ++i) {
+			// OpenList（水色）
+			m_traces[i].eachOpen([&](const Point& p) { Circle{ toScreen(p), 5 }.draw(Palette::Skyblue); });
+
+			// ClosedList（灰色）
+			m_traces[i].eachClosed([&](const Point& p) { Circle{ toScreen(p), 5 }.draw(Palette::Gray); });
+
+			// FinalRoute（赤線）
+			lineRoute.clear();
+			for (const auto& fr : m_routes[i]) {
+				lineRoute << toScreen(fr);
+			}
+			LineString{ lineRoute }.draw(5, Palette::Red);
+		}
+	}
+
+	// Draw the enemies themselves
+	// 画面に入るマスだけを調べる（敵の総数ではなく画面の広さに比例する）
+	for (int32 y = visibleTiles.y; y < visibleTiles.y + visibleTiles.h; ++y) {
+		for (int32 x = visibleTiles.x; x < visibleTiles.x + visibleTiles.w; ++x) {
+			const auto index = occupancy.enemyAt(Point{ x, y });
+			if (!index || isDead(*index)) continue; // Only draw if alive
+			if (!playerView.isVisible(Point{ x, y })) continue; // 霧の中の敵は描かない
+
+			RectF enemyBodyRect(
+				(x * pieceSize) + (wallThickness * (x + 1)) - camera.x,
+				(y * pieceSize) + (wallThickness * (y + 1)) - camera.y,
+				pieceSize,
+				pieceSize
+			);
+			enemyBodyRect.rounded(3).draw(status(*index).color); // Use the enemy's status color
+		}
+	}
+}
+
+void EnemyStore::patrol(size_t index, const TileGrid& mapData, OccupancyGrid& occupancy, PathFinder& pathFinder) {
+	const Point target = patrolTarget(index);
+	if (searchRoute(index, target, mapData, occupancy, pathFinder) && m_route.size() > 1) {
+		stepTo(index, m_route[1], occupancy);
+
+		// 目的地に到達したら次の巡回ポイントへ
+		if (m_positions[index] == target) {
+			m_patrolIndices[index] = (m_patrolIndices[index] + 1) % PatrolPointCount;
+		}
+	}
+}
+
+// 退避処理：巡回ルートに戻る
+void EnemyStore::retreat(size_t index, const TileGrid& mapData, OccupancyGrid& occupancy, PathFinder& pathFinder) {
+	const Point target = patrolTarget(index); // 現在の巡回ポイントへ戻る
+	if (searchRoute(index, target, mapData, occupancy, pathFinder) && m_route.size() > 1) {
+		stepTo(index, m_route[1], occupancy);
+
+		if (m_positions[index] == target) {
+			m_states[index] = EnemyState::PATROL;
+			m_chaseCounts[index] = 0;
+		}
+	}
+}
@@ -0,0 +1,85 @@
+﻿#pragma once
+#include "EnemyDataBase.hpp"
+#include "FlowField.hpp"
+#include "PathFinder.hpp"
+#include "OccupancyGrid.hpp"
+#include "VisibilityCache.hpp"
+#include "FieldOfView.hpp"
+
+// 敵の行動状態を定義
+enum class EnemyState : uint8 {
+	IDLE,    // 待機中
+	PATROL,  // 巡回中
+	CHASE,   // プレイヤーを追跡中
+	ATTACK,  // 攻撃中
+	RETREAT  // 退避中（巡回地点へ戻る）
+};
+
+// 全ての敵をまとめて持つ入れ物
+// 敵1体ごとに new せず、項目ごとの配列（位置・HP・状態…）に詰めて持つ（Structure of Arrays）。
+// ターンの処理は連続したメモリを順に読むだけで済み、reserve した数までは出現でヒープ確保をしない。
+// 倒れた敵は最後の敵と入れ替えて取り除くので、敵の番号（添字）は取り除くたびに変わる。
+// マスからの逆引きは OccupancyGrid::enemyAt を使う（番号は出現・移動・削除のたびに更新される）。
+class EnemyStore {
+public:
+	void clear();
+	void reserve(size_t capacity);
+
+	size_t size() const { return m_positions.size(); }
+	bool isEmpty() const { return m_positions.isEmpty(); }
+
+	// 敵を出現させ、その番号を返す（占有情報にも番号を登録する）
+	size_t spawn(Point pos, int32 typeId, OccupancyGrid& occupancy);
+
+	// index の敵を最後の敵と入れ替えて取り除く（入れ替わった敵の番号も占有情報に反映する）
+	void removeAt(size_t index, OccupancyGrid& occupancy);
+
+	// HP が 0 以下の敵を全て取り除き、占有情報からも外す
+	void removeDead(OccupancyGrid& occupancy);
+
+	Point position(size_t index) const { return m_positions[index]; }
+	int32 hp(size_t index) const { return m_hp[index]; }
+	bool isDead(size_t index) const { return m_hp[index] <= 0; }
+	EnemyState state(size_t index) const { return m_states[index]; }
+	const StertsBase& status(size_t index) const { return EnemyDataBase::Get(m_typeIds[index]); }
+	const Array<Point>& positions() const { return m_positions; }
+
+	void damage(size_t index, int32 amount) { m_hp[index] -= amount; }
+
+	// index の敵の1ターン分の行動（プレイヤーに与えるダメージを返す）
+	int32 act(size_t index, Point player, const TileGrid& mapData, const VisibilityCache& visibility, OccupancyGrid& occupancy, const FlowField& playerField, PathFinder& pathFinder);
+
+	// visibleTiles（Camera::GetVisibleTiles）に入り、プレイヤーから見えている敵の描画（探索状況の可視化付き）
+	void draw(int pieceSize, int wallThickness, Point camera, const Rect& visibleTiles, const OccupancyGrid& occupancy, const FieldOfView& playerView) const;
+
+private:
+	void chase(size_t index, OccupancyGrid& occupancy, const FlowField& playerField);  // 追跡処理（共有フローフィールドを参照）
+	void patrol(size_t index, const TileGrid& mapData, OccupancyGrid& occupancy, PathFinder& pathFinder);   // 巡回処理
+	void retreat(size_t index, const TileGrid& mapData, OccupancyGrid& occupancy, PathFinder& pathFinder);  // 退避処理
+
+	bool searchRoute(size_t index, Point goal, const TileGrid& mapData, const OccupancyGrid& occupancy, PathFinder& pathFinder);  // 共有エンジンでA*経路探索
+	void stepTo(size_t index, Point next, OccupancyGrid& occupancy);  // 1マス進む（占有情報も移す）
+
+	// 現在の巡回ターゲット（巡回ルートは出現位置を角とする正方形）
+	Point patrolTarget(size_t index) const { return m_patrolOrigins[index] + PatrolOffsets[m_patrolIndices[index]]; }
+
+	static constexpr int32 AttackRange = 1;    // 攻撃範囲
+	static constexpr int32 MaxChaseCount = 5;  // これを超えたら退避する
+	static constexpr Point PatrolOffsets[] = { { 0, 0 }, { 2, 0 }, { 2, 2 }, { 0, 2 } };
+	static constexpr int32 PatrolPointCount = static_cast<int32>(std::size(PatrolOffsets));
+
+	// 敵1体ぶんの項目を、それぞれ別の配列に持つ（添字が敵の番号）
+	Array<Point> m_positions;        // 現在位置
+	Array<int32> m_hp;               // 現在のHP
+	Array<int32> m_typeIds;          // ステータス表の番号
+	Array<EnemyState> m_states;      // 状態管理
+	Array<int32> m_chaseCounts;      // 追跡しているターン数
+	Array<int32> m_patrolIndices;    // 現在の巡回ターゲットのインデックス
+	Array<Point> m_patrolOrigins;    // 巡回ルートの基準点（出現位置）
+
+	// 探索の記録と最後の経路（可視化用。トレースが無効なビルドでは空のまま）
+	Array<EnemySearchTrace> m_traces;
+	Array<Array<Point>> m_routes;
+
+	Array<Point> m_route;            // 経路探索の作業領域（全ての敵で使い回す）
+};
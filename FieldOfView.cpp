@@ -0,0 +1,103 @@
+﻿
+#include "FieldOfView.hpp"
+
+namespace {
+	// 八分円ごとの座標変換（走査の (列, 行) をマップの (x, y) に向ける）
+	constexpr int32 OctantXX[] = { 1, 0, 0, -1, -1, 0, 0, 1 };
+	constexpr int32 OctantXY[] = { 0, 1, -1, 0, 0, -1, 1, 0 };
+	constexpr int32 OctantYX[] = { 0, 1, 1, 0, 0, -1, -1, 0 };
+	constexpr int32 OctantYY[] = { 1, 0, 0, 1, -1, 0, 0, -1 };
+
+	// 視線を遮るマス（マップの外も遮る）
+	bool BlocksSightAt(const TileGrid& tiles, Point p) {
+		return !tiles.inBounds(p) || BlocksSight(tiles[p]);
+	}
+}
+
+void FieldOfView::reset(Size mapSize) {
+	const size_t wordCount = ((static_cast<size_t>(mapSize.x) * mapSize.y) + 63) / 64;
+	m_mapSize = mapSize;
+	m_origin = Point{ -1, -1 };
+	m_visible.assign(wordCount, 0);
+	m_explored.assign(wordCount, 0);
+	m_visibleTiles.clear();
+	m_newlyExplored.clear();
+
+	// 視界の最大の広さぶん確保しておけば、ターン中に確保し直すことはない
+	constexpr size_t MaxVisible = static_cast<size_t>((Radius * 2) + 1) * ((Radius * 2) + 1);
+	m_visibleTiles.reserve(MaxVisible);
+	m_newlyExplored.reserve(MaxVisible);
+}
+
+void FieldOfView::markVisible(Point p) {
+	if (!InRange(p.x, 0, m_mapSize.x - 1) || !InRange(p.y, 0, m_mapSize.y - 1)) return;
+
+	const size_t i = bitIndex(p);
+	const uint64 bit = (uint64{ 1 } << (i % 64));
+	if (m_visible[i / 64] & bit) return; // 八分円の境目は2回通る
+
+	m_visible[i / 64] |= bit;
+	m_visibleTiles << p;
+
+	if (!(m_explored[i / 64] & bit)) {
+		m_explored[i / 64] |= bit;
+		m_newlyExplored << p;
+	}
+}
+
+void FieldOfView::update(Point origin, const TileGrid& tiles) {
+	m_newlyExplored.clear();
+	if (origin == m_origin) return;
+	m_origin = origin;
+
+	// 前回見えていたマスだけを消す
+	for (const auto& p : m_visibleTiles) {
+		const size_t i = bitIndex(p);
+		m_visible[i / 64] &= ~(uint64{ 1 } << (i % 64));
+	}
+	m_visibleTiles.clear();
+
+	markVisible(origin);
+	for (int32 octant = 0; octant < 8; ++octant) {
+		castLight(tiles, 1, 1.0, 0.0, OctantXX[octant], OctantXY[octant], OctantYX[octant], OctantYY[octant]);
+	}
+}
+
+// 八分円を視点から row 行目より外へ走査する（startSlope〜endSlope の傾きの範囲だけが光の当たる範囲）
+// 壁に当たったら、その手前までの範囲を1行外から再帰で調べ、残りの範囲で走査を続ける
+void FieldOfView::castLight(const TileGrid& tiles, int32 row, double startSlope, double endSlope, int32 xx, int32 xy, int32 yx, int32 yy) {
+	if (startSlope < endSlope) return;
+
+	constexpr int32 RadiusSq = (Radius * Radius) + Radius; // 切り捨てずに少し丸く見せる
+	double nextStartSlope = startSlope;
+	for (int32 j = row; j <= Radius; ++j) {
+		bool blocked = false;
+		const int32 dy = -j;
+		for (int32 dx = -j; dx <= 0; ++dx) {
+			const double leftSlope = (dx - 0.5) / (dy + 0.5);
+			const double rightSlope = (dx + 0.5) / (dy - 0.5);
+			if (startSlope < rightSlope) continue;
+			if (endSlope > leftSlope) break;
+
+			const Point p{ m_origin.x + (dx * xx) + (dy * xy), m_origin.y + (dx * yx) + (dy * yy) };
+			if (((dx * dx) + (dy * dy)) <= RadiusSq) {
+				markVisible(p);
+			}
+
+			if (blocked) {
+				if (BlocksSightAt(tiles, p)) {
+					nextStartSlope = rightSlope;
+					continue;
+				}
+				blocked = false;
+				startSlope = nextStartSlope;
+			}
+			else if (BlocksSightAt(tiles, p) && (j < Radius)) {
+				blocked = true;
+				castLight(tiles, j + 1, startSlope, leftSlope, xx, xy, yx, yy);
+				nextStartSlope = rightSlope;
+			}
+		}
+		if (blocked) break;
+	}
+}
@@ -0,0 +1,44 @@
+﻿#pragma once
+# include "Common.hpp"
+# include "Tile.hpp"
+
+// プレイヤーの視界と探索済みのマス（霧）
+// 視界は再帰的シャドウキャスティングで、視点を中心とする8つの八分円を壁の影を避けながら走査して求める。
+// 見えているマス・一度でも見たマスはそれぞれ1マス1ビットで持ち、
+// 視点が動いたときだけ、前回見えていたマスを消してから新しい視界を塗る（マップ全体は触らない）。
+class FieldOfView {
+public:
+	static constexpr int32 Radius = 8;  // 見える距離（マス）
+
+	// 全てのマスを未探索にする（前と同じ大きさなら確保済みの領域に上書きする）
+	void reset(Size mapSize);
+
+	// origin から見えるマスを求め直す（origin が前回と同じなら何もしない）
+	void update(Point origin, const TileGrid& tiles);
+
+	bool isVisible(Point p) const { return test(m_visible, p); }
+	bool isExplored(Point p) const { return test(m_explored, p); }
+
+	// 今見えているマス
+	const Array<Point>& visibleTiles() const { return m_visibleTiles; }
+	// 直前の update で初めて見えたマス（描画側はこのマスだけを描き直せばよい）
+	const Array<Point>& newlyExplored() const { return m_newlyExplored; }
+
+private:
+	bool test(const Array<uint64>& bits, Point p) const {
+		if (!InRange(p.x, 0, m_mapSize.x - 1) || !InRange(p.y, 0, m_mapSize.y - 1)) return false;
+		const size_t i = bitIndex(p);
+		return ((bits[i / 64] >> (i % 64)) & 1) != 0;
+	}
+	size_t bitIndex(Point p) const { return (static_cast<size_t>(p.y) * m_mapSize.x) + p.x; }
+
+	void markVisible(Point p);
+	void castLight(const TileGrid& tiles, int32 row, double startSlope, double endSlope, int32 xx, int32 xy, int32 yx, int32 yy);
+
+	Size m_mapSize{ 0, 0 };
+	Point m_origin{ -1, -1 };
+	Array<uint64> m_visible;          // 今見えているマス
+	Array<uint64> m_explored;         // 一度でも見えたマス
+	Array<Point> m_visibleTiles;      // m_visible の立っているマス（次の update で消すため）
+	Array<Point> m_newlyExplored;
+};
@@ -0,0 +1,63 @@
+﻿
+#include "FloorPlan.hpp"
+#include "MapGenerator.hpp"
+
+FloorPlan GenerateFloorPlan(const MapConfig& config, uint64 seed) {
+	FloorPlan plan;
+	plan.seed = seed;
+	plan.config = config;
+
+	// 生成器がそのままゲームで使う地形（部屋・通路・スタート・ゴール）を作る
+	MapGenerator generator{ config, seed };
+	plan.tiles = generator.generateFullMap(generator.generateMiniMap());
+
+	plan.start = generator.startTile_generated;
+	plan.goal = generator.goalTile_generated;
+	if (!plan.isValid()) {
+		return plan;
+	}
+
+	const Point playerStartPos = plan.start.value();
+	const Point goalPos = plan.goal.value();
+	const TileGrid& tiles = plan.tiles;
+
+	// 通れるマスの表を作り、スタートから歩いて行けるマスをビット演算でまとめて塗りつぶす
+	plan.walkable.build(tiles);
+	WalkableBitboard spawnCandidates = plan.walkable.floodFill(playerStartPos);
+	if (!spawnCandidates.isWalkable(goalPos)) {
+		// 部屋グラフで全ての部屋を繋いでいるので起きないはずだが、ゴールに行けない階は生成の失敗として扱う
+		plan.goal.reset();
+		return plan;
+	}
+
+	// 敵の出現位置を決める（スタートとゴールの部屋には出さない）
+	// 候補はスタートから行ける床（スタートとゴールのマスは除く）。選んだマスは候補から外すので同じマスには出さない
+	spawnCandidates.set(playerStartPos, false);
+	spawnCandidates.set(goalPos, false);
+	for (const auto& roomAreaRect : generator.generatedRoomAreas) {
+		if (roomAreaRect.contains(playerStartPos) || roomAreaRect.contains(goalPos)) {
+			continue;
+		}
+
+		// 例：敵の生成ルール：エリアの25タイルごとに1体の敵を生成し、1部屋あたり最大3体まで。最小0体。
+		const int numEnemiesToSpawn = Clamp((roomAreaRect.w * roomAreaRect.h) / 25, 0, 3);
+
+		// 部屋の中の候補を数え、その中から一様に選ぶ（試行の打ち切りで出し損ねることがない）
+		size_t candidateCount = spawnCandidates.count(roomAreaRect);
+		for (int i = 0; (i < numEnemiesToSpawn) && (candidateCount > 0); ++i) {
+			const size_t pick = static_cast<size_t>(Random(0, static_cast<int32>(candidateCount) - 1, generator.rng()));
+			if (const auto spawnPos = spawnCandidates.nth(roomAreaRect, pick)) {
+				plan.enemySpawns << *spawnPos;
+				spawnCandidates.set(*spawnPos, false);
+				--candidateCount;
+			}
+		}
+	}
+
+	// 視界表は重いので、生成と一緒にワーカースレッドで作っておく
+	plan.visibility.build(tiles);
+
+	plan.roomAreas = std::move(generator.generatedRoomAreas);
+	plan.roomGraph = std::move(generator.generatedRoomGraph);
+	return plan;
+}
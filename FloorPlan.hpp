@@ -0,0 +1,27 @@
+﻿#pragma once
+# include "Common.hpp"
+#include "RoomGraph.hpp"
+#include "Tile.hpp"
+#include "VisibilityCache.hpp"
+#include "WalkableBitboard.hpp"
+
+// 1階層ぶんの生成結果（マップ・スタート/ゴール・部屋・敵の配置）
+// シーンにも描画にも依存しないので、ワーカースレッドで作って後から Game に渡せる
+struct FloorPlan {
+	uint64 seed = 0;                 // 生成に使ったシード
+	MapConfig config;                // 生成したときの大きさ
+	TileGrid tiles;                  // 地形（生成器が作ったものをそのまま使う。1マス1バイト）
+	Optional<Point> start;
+	Optional<Point> goal;
+	Array<Rect> roomAreas;           // 部屋の矩形
+	RoomGraph roomGraph;             // 部屋と通路の接続グラフ
+	Array<Point> enemySpawns;        // 敵を出現させるマス（重複しない）
+	WalkableBitboard walkable;       // tiles の通れるマス（1マス1ビット）
+	VisibilityCache visibility;      // tiles から求めた視界表（地形は変わらないので生成時に1回だけ作る）
+
+	// スタートとゴールが決まっていれば遊べる
+	bool isValid() const { return start.has_value() && goal.has_value(); }
+};
+
+// 大きさとシードから1階層を生成する（同じ引数なら常に同じ結果。別スレッドから呼んでもよい）
+FloorPlan GenerateFloorPlan(const MapConfig& config, uint64 seed);
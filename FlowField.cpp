@@ -0,0 +1,72 @@
+﻿
+#include "FlowField.hpp"
+
+namespace {
+	// 8方向の移動量（直線を先に並べ、同じ歩数なら直線移動を優先する）
+	constexpr auto& Directions = WalkableBitboard::Directions;
+}
+
+void FlowField::build(Point goal, const WalkableBitboard& walkable, int32 maxDistance) {
+	if (m_distance.size() != walkable.size()) {
+		m_distance.assign(walkable.size().x, walkable.size().y, Unreachable);
+		m_visited.clear();
+	}
+	else {
+		// 前回訪問したマスだけを戻す（マップ全体を埋め直さない）
+		for (const auto& p : m_visited) {
+			m_distance[p] = Unreachable;
+		}
+		m_visited.clear();
+	}
+
+	m_goal = goal;
+	if (!m_distance.inBounds(goal)) return;
+
+	// 移動コストは全て1なので、Dijkstra は幅優先探索で済む
+	m_distance[goal] = 0;
+	m_visited << goal;
+
+	for (size_t head = 0; head < m_visited.size(); ++head) {
+		const Point current = m_visited[head];
+		const int32 nextDistance = m_distance[current] + 1;
+		if (nextDistance > maxDistance) continue;
+
+		// 周囲8マスの壁とマップの外はビット表から1回で除く
+		const uint8 walkableMask = walkable.neighborMask(current);
+		for (size_t i = 0; i < std::size(Directions); ++i) {
+			if (!((walkableMask >> i) & 1)) continue;
+
+			const Point neighbor = current + Directions[i];
+			if (m_distance[neighbor] != Unreachable) continue;
+
+			m_distance[neighbor] = nextDistance;
+			m_visited << neighbor;
+		}
+	}
+}
+
+int32 FlowField::distanceAt(Point p) const {
+	if (!m_distance.inBounds(p)) return Unreachable;
+	return m_distance[p];
+}
+
+Optional<Point> FlowField::nextStep(Point from, const OccupancyGrid& occupancy) const {
+	Optional<Point> best;
+	int32 bestDistance = distanceAt(from);
+
+	for (const auto& dir : Directions) {
+		const Point neighbor = from + dir;
+		if (neighbor == m_goal) continue;
+
+		const int32 d = distanceAt(neighbor);
+		if (d >= bestDistance) continue;
+
+		// 他の敵がいるマスには進まない（壁は距離が Unreachable なので上で除かれる）
+		if (occupancy.isOccupied(neighbor)) continue;
+
+		bestDistance = d;
+		best = neighbor;
+	}
+
+	return best;
+}
@@ -0,0 +1,27 @@
+﻿#pragma once
+# include "Common.hpp"
+# include "OccupancyGrid.hpp"
+# include "WalkableBitboard.hpp"
+
+// プレイヤーまでの距離マップ（Dijkstra map）
+// プレイヤーが動いたときに1回だけ構築し、全ての敵が共有して参照する
+class FlowField {
+public:
+	static constexpr int32 Unreachable = INT32_MAX;  // 到達不能（または範囲外）
+
+	// goal からの8方向歩数を計算する（walkable の通れないマスのみ通行不可、maxDistance 歩まで）
+	void build(Point goal, const WalkableBitboard& walkable, int32 maxDistance = Unreachable);
+
+	// 指定マスの goal までの歩数
+	int32 distanceAt(Point p) const;
+
+	// from から goal に1歩近づくマスを返す（誰かがいるマスや goal 自身には進まない）
+	Optional<Point> nextStep(Point from, const OccupancyGrid& occupancy) const;
+
+	Point getGoal() const { return m_goal; }
+
+private:
+	Grid<int32> m_distance;   // 各マスの歩数
+	Array<Point> m_visited;   // BFSキュー兼、前回訪問したマスの記録（次回のリセット用）
+	Point m_goal = { -1, -1 };
+};
@@ -0,0 +1,57 @@
+﻿
+#include "FullMapRenderer.hpp"
+
+namespace {
+	Color PixelColor(Tile tileType, const ColorF& floorColor) {
+		const auto color = TileColor(tileType, floorColor);
+		return color ? Color{ *color } : Color{ 0, 0 };
+	}
+}
+
+void FullMapRenderer::reset(const TileGrid& tiles, const FieldOfView* view, const ColorF& floorColor) {
+	m_floorColor = floorColor;
+
+	// 同じ大きさなら画像とテクスチャを作り直さずに上書きする
+	const bool sameSize = (m_texture && (m_image.size() == tiles.size()));
+	if (!sameSize) {
+		m_image = Image{ tiles.size(), Color{ 0, 0 } };
+	}
+	for (int32 y = 0; y < static_cast<int32>(tiles.height()); ++y) {
+		for (int32 x = 0; x < static_cast<int32>(tiles.width()); ++x) {
+			const bool explored = (!view || view->isExplored(Point{ x, y }));
+			m_image[y][x] = explored ? PixelColor(tiles[y][x], m_floorColor) : Color{ 0, 0 };
+		}
+	}
+	if (sameSize) {
+		m_texture.fill(m_image);
+	}
+	else {
+		m_texture = DynamicTexture{ m_image };
+	}
+	m_dirty = false;
+}
+
+void FullMapRenderer::updateTile(Point tile, Tile tileType) {
+	if (!InRange(tile.x, 0, static_cast<int32>(m_image.width()) - 1) || !InRange(tile.y, 0, static_cast<int32>(m_image.height()) - 1)) return;
+
+	const Color color = PixelColor(tileType, m_floorColor);
+	if (m_image[tile] != color) {
+		m_image[tile] = color;
+		m_dirty = true;
+	}
+}
+
+void FullMapRenderer::prepare() {
+	if (m_dirty && m_texture) {
+		m_texture.fill(m_image);
+		m_dirty = false;
+	}
+}
+
+void FullMapRenderer::draw(const Vec2& pos, double tileSize) const {
+	if (!m_texture) return;
+
+	// 拡大してもマスの境目をぼかさない
+	const ScopedRenderStates2D sampler{ SamplerState::ClampNearest };
+	m_texture.scaled(tileSize).draw(pos);
+}
@@ -0,0 +1,28 @@
+﻿#pragma once
+# include "Common.hpp"
+# include "FieldOfView.hpp"
+
+// 全体マップ（M キーで表示）の地形
+// 1マスを1ピクセルとした Image を DynamicTexture に載せておき、拡大して1枚で描く。
+// マスが変わったとき・初めて探索したときだけ Image を書き換え、次の draw の前にテクスチャへ反映する。
+class FullMapRenderer {
+public:
+	// tiles から画像を作り直す（前と同じ大きさなら確保済みの画像とテクスチャに上書きする）
+	// view を渡したときは探索済みのマスだけを描く
+	void reset(const TileGrid& tiles, const FieldOfView* view, const ColorF& floorColor);
+
+	// マスの種類が変わったとき・初めて探索したときに呼ぶ（そのピクセルだけ書き換える）
+	void updateTile(Point tile, Tile tileType);
+
+	// 書き換えたピクセルがあればテクスチャへ反映する（draw の前に呼ぶ）
+	void prepare();
+
+	// 左上 pos から、1マス tileSize ピクセルで描く
+	void draw(const Vec2& pos, double tileSize) const;
+
+private:
+	Image m_image;             // 1マス = 1ピクセル（描かないマスは透明）
+	DynamicTexture m_texture;
+	ColorF m_floorColor = Palette::White;
+	bool m_dirty = false;      // テクスチャに反映していない書き換えがある
+};
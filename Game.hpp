@@ -1,10 +1,11 @@
 ﻿# pragma once﻿
 # include "Common.hpp"
 #include "Camera.hpp"
-# include"BaseEnemy.hpp"
-# include"BasePlayer.hpp"
 #include "MapGenerator.hpp"
 #include"Particle.hpp"
+#include "Simulation.hpp"
+#include "TerrainRenderer.hpp"
+#include "FullMapRenderer.hpp"
 
 enum class MoveMode
 {
@@ -30,21 +31,32 @@ public:
 
 private:
 	void GenerateAndSetupNewMap(); // Added
+	// シーンを作り直さずに次の階へ進む（プレイヤー・カメラ・作業領域はそのまま使い回す）
+	void AdvanceFloor();
+	// 先読み済みの階があればそれを、なければその場で生成した階を返す
+	FloorPlan TakeFloorPlan(const MapConfig& config, uint64 seed);
 
 	//マップ系
-	Grid<int32> currentMapGrid; // 動的に生成されたマップを保存します。
+	// 地形・プレイヤー・敵とターンのルールはシミュレーションが持つ（Game は入力と演出・描画だけ）
+	Simulation m_sim;
+	// 1フレームで、遠くで眠っている敵の行動に使う時間（入力の処理では近くの敵だけを動かす）
+	static constexpr Duration SleepingEnemyBudget = 2ms;
 	// 壁の厚さ
 	int WallThickness = 5;
 	//ピースのサイズ
 	int PieceSize = 30;
-	//現在のステージ
-	static short s_currentStage; // Changed to static
-
-	MapGenerator generator;
+	// 最大の階数（現在の階は GameData::Stage）
+	static constexpr int32 MaxStages = 10;
+	// 次の階を裏で生成するタスク
+	AsyncTask<FloorPlan> m_nextFloorTask;
 
 
 	//ピースカラー
 	ColorF PieceColor = Palette::White;
+	// 地形はチャンクごとのテクスチャに焼き込んで描く
+	TerrainRenderer m_terrain;
+	// 全体マップの地形（1マス1ピクセルのテクスチャ）
+	FullMapRenderer m_fullMap;
 	//////////////////////////////////
 	//ウィンドウ
 	const Rect MessageWindow{ 0,450,800,150 };
@@ -52,24 +64,13 @@ private:
 	const Rect CharaWindow{ 650, 80, 150, 370 };
 
 	RectF getPaddle(int _x, int _y)const;
+	// 揺れを含めたカメラ位置
+	Vec2 getShakenCamera() const;
+	// 画面に入るマスの範囲（描画はこの範囲だけを扱う）
+	Rect getVisibleTiles() const;
 
 	//////////////////////////////////
-	//キャラ
-	const Texture texture[8]{
-		Texture{Image(Resource(U"example/トゥマレ/トゥマレ_通常.png")).thresholded_Otsu()},
-		Texture{Image(Resource(U"example/トゥマレ/トゥマレ_笑顔.png")).thresholded_Otsu()},
-		Texture{Image(Resource(U"example/トゥマレ/トゥマレ_怒り.png")).thresholded_Otsu()},
-		Texture{Image(Resource(U"example/トゥマレ/トゥマレ_呆れ.png")).thresholded_Otsu()},
-		Texture{Image(Resource(U"example/トゥマレ/トゥマレ_苦笑い.png")).thresholded_Otsu()},
-		Texture{Image(Resource(U"example/トゥマレ/トゥマレ_驚き.png")).thresholded_Otsu()},
-		Texture{Image(Resource(U"example/トゥマレ/トゥマレ_口開き.png")).thresholded_Otsu()},
-		Texture{Image(Resource(U"example/トゥマレ/トゥマレ_目閉じ.png")).thresholded_Otsu()}
-	};
-
-
-	BasePlayer* Player = nullptr;
-
-	Array<BaseEnemy*> Enemys;
+	//キャラ（画像は TextureCache から引く）
 
 	Camera* camera = nullptr;
 
@@ -95,5 +96,6 @@ private:
 	s3d::Timer m_playerSlideAnimTimer{ 0.12s, s3d::StartImmediately::No }; // Duration of slide
 
 public: // Made public for access in Game.cpp for now, can be refactored if Game class owns render consts
-	static constexpr int FullMapTileRenderSize = 8;
+	static constexpr int FullMapTileRenderSize = 8;       // 全体マップの1マスの最大ピクセル数
+	static constexpr double FullMapRenderExtent = 400.0;  // 全体マップの一辺の最大ピクセル数
 };
@@ -2,6 +2,7 @@
 # include "Title.hpp"
 # include "Game.hpp"
 # include "Ranking.hpp"
+# include "TextureCache.hpp"
 
 void Main()
 {
@@ -10,6 +11,9 @@ void Main()
 
 	FontAsset::Register(U"Bold", FontMethod::MSDF, 48, Typeface::Bold);
 
+	// 立ち絵の二値化結果を保存しておき、次回の起動から使う
+	TextureCache::SetDiskCacheDirectory(U"cache/textures/");
+
 	App manager;
 	manager.add<Title>(State::Title);
 	manager.add<Game>(State::Game);
@@ -25,4 +29,7 @@ void Main()
 			break;
 		}
 	}
+
+	// 共有テクスチャはエンジンの終了処理より前に手放す
+	TextureCache::Clear();
 }
@@ -0,0 +1,129 @@
+﻿
+#include "MapGenBatch.hpp"
+#include "MapGenerator.hpp"
+#include <cstring> // For std::memcpy
+
+namespace {
+	constexpr uint32 DumpVersion = 1;
+
+	// 1つのスレッドが担当する範囲の結果
+	struct ChunkResult {
+		Array<int32> roomCounts;
+		Array<int32> repairCounts;
+		int32 failedCount = 0;
+		Array<uint8> dump;  // 書き出す場合のみ、担当範囲のフロアをシード順に詰めたもの
+	};
+
+	template <class Type>
+	void AppendBytes(Array<uint8>& bytes, const Type& value) {
+		const size_t offset = bytes.size();
+		bytes.resize(offset + sizeof(Type));
+		std::memcpy(bytes.data() + offset, &value, sizeof(Type));
+	}
+
+	void AppendFloor(Array<uint8>& bytes, uint64 seed, const TileGrid& map, const MapGenerator& generator) {
+		const Point start = generator.startTile_generated.value_or(Point{ -1, -1 });
+		const Point goal = generator.goalTile_generated.value_or(Point{ -1, -1 });
+		AppendBytes(bytes, seed);
+		AppendBytes(bytes, static_cast<int32>(start.x));
+		AppendBytes(bytes, static_cast<int32>(start.y));
+		AppendBytes(bytes, static_cast<int32>(goal.x));
+		AppendBytes(bytes, static_cast<int32>(goal.y));
+		AppendBytes(bytes, static_cast<uint32>(generator.generatedRoomAreas.size()));
+
+		// 床/壁を 1 マス 1 ビットに詰める
+		const size_t offset = bytes.size();
+		bytes.resize(offset + (map.num_elements() + 7) / 8, 0);
+		size_t bit = 0;
+		for (const Tile tile : map) {
+			if (IsPassable(tile)) {
+				bytes[offset + bit / 8] |= static_cast<uint8>(1u << (bit % 8));
+			}
+			++bit;
+		}
+	}
+
+	ChunkResult GenerateChunk(const MapConfig& config, uint64 firstSeed, int32 count, bool dump) {
+		ChunkResult result;
+		result.roomCounts.reserve(count);
+		result.repairCounts.reserve(count);
+
+		MapGenerator generator{ config };
+		for (int32 i = 0; i < count; ++i) {
+			const uint64 seed = firstSeed + i;
+			generator.setSeed(seed);
+			const TileGrid map = generator.generateFullMap(generator.generateMiniMap());
+
+			if (!generator.startTile_generated.has_value() || !generator.goalTile_generated.has_value()) {
+				++result.failedCount;
+			}
+			result.roomCounts << static_cast<int32>(generator.generatedRoomAreas.size());
+			result.repairCounts << generator.connectivityRepairCount;
+
+			if (dump) {
+				AppendFloor(result.dump, seed, map, generator);
+			}
+		}
+		return result;
+	}
+}
+
+MapGenBatchResult RunMapGenBatch(const MapGenBatchOptions& options) {
+	MapGenBatchResult result;
+	const int32 count = Max(options.count, 0);
+	const int32 threads = Clamp((options.threads > 0) ? options.threads : static_cast<int32>(Threading::GetConcurrency()), 1, Max(count, 1));
+	const bool dump = (not options.dumpPath.isEmpty());
+
+	// シードの範囲をスレッド数で分けて並列に生成する
+	const Stopwatch stopwatch{ StartImmediately::Yes };
+	Array<AsyncTask<ChunkResult>> tasks;
+	for (int32 t = 0; t < threads; ++t) {
+		const int32 begin = static_cast<int32>(static_cast<int64>(count) * t / threads);
+		const int32 end = static_cast<int32>(static_cast<int64>(count) * (t + 1) / threads);
+		tasks << Async(GenerateChunk, options.config, options.firstSeed + begin, end - begin, dump);
+	}
+
+	Array<ChunkResult> chunks;
+	for (auto& task : tasks) {
+		chunks << task.get();
+	}
+	result.elapsedSec = stopwatch.sF();
+
+	// 統計をまとめる
+	bool first = true;
+	for (const auto& chunk : chunks) {
+		result.failedCount += chunk.failedCount;
+		for (const int32 rooms : chunk.roomCounts) {
+			if (static_cast<int32>(result.roomHistogram.size()) <= rooms) {
+				result.roomHistogram.resize(rooms + 1, 0);
+			}
+			++result.roomHistogram[rooms];
+		}
+		for (const int32 repairs : chunk.repairCounts) {
+			result.repairMin = first ? repairs : Min(result.repairMin, repairs);
+			result.repairMax = first ? repairs : Max(result.repairMax, repairs);
+			result.repairTotal += repairs;
+			first = false;
+		}
+		result.mapCount += static_cast<int32>(chunk.roomCounts.size());
+	}
+	result.mapsPerSec = (result.elapsedSec > 0.0) ? (result.mapCount / result.elapsedSec) : 0.0;
+
+	// 担当範囲の順に並べればシード順になる
+	if (dump) {
+		BinaryWriter writer{ options.dumpPath };
+		if (writer) {
+			writer.write("DWMP", 4);
+			writer.write(DumpVersion);
+			writer.write(static_cast<uint32>(result.mapCount));
+			writer.write(static_cast<int32>(options.config.miniSize));
+			writer.write(static_cast<int32>(options.config.roomUnit));
+			for (const auto& chunk : chunks) {
+				writer.write(chunk.dump.data(), static_cast<int64>(chunk.dump.size()));
+			}
+			result.dumpWritten = true;
+		}
+	}
+
+	return result;
+}
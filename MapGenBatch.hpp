@@ -0,0 +1,32 @@
+﻿#pragma once
+# include "Common.hpp"
+
+// マップ生成をまとめて実行する設定
+struct MapGenBatchOptions {
+	uint64 firstSeed = 1;   // 最初のシード（i 番目のフロアは firstSeed + i で生成する）
+	int32 count = 1000;     // 生成するフロア数
+	int32 threads = 0;      // 使うスレッド数（0 なら CPU のコア数）
+	MapConfig config;       // フロアの大きさ
+	FilePath dumpPath;      // 空でなければ生成したフロアをバイナリで書き出す
+};
+
+// マップ生成をまとめて実行した結果
+struct MapGenBatchResult {
+	int32 mapCount = 0;             // 生成したフロア数
+	int32 failedCount = 0;          // スタートかゴールが決まらなかったフロア数
+	double elapsedSec = 0.0;        // 全体の経過時間
+	double mapsPerSec = 0.0;        // 1秒あたりの生成数
+	Array<int32> roomHistogram;     // 部屋数ごとのフロア数（添字が部屋数）
+	int32 repairMin = 0;            // 離れた部屋を繋いだ通路の数（最小・最大・合計）
+	int32 repairMax = 0;
+	int64 repairTotal = 0;
+	bool dumpWritten = false;       // 書き出しに成功したか
+};
+
+// フロアを複数スレッドで生成して統計を取る（ウィンドウを開かずに生成の調整や速度の確認に使う）
+//
+// 書き出すファイルの形式（リトルエンディアン）
+//   ヘッダ   : "DWMP"、uint32 版番号(1)、uint32 フロア数、int32 ミニマップの一辺、int32 部屋の一辺
+//   フロア毎 : uint64 シード、int32 スタート x,y、int32 ゴール x,y、uint32 部屋数、
+//              マップの床(1)/壁(0)を行優先で 1 マス 1 ビットに詰めたもの（下位ビットから、ceil(w*h/8) バイト）
+MapGenBatchResult RunMapGenBatch(const MapGenBatchOptions& options);
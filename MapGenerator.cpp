@@ -1,49 +1,133 @@
 ﻿
 #include "MapGenerator.hpp"
-#include <queue> // For std::queue in BFS
-#include <utility> // For std::pair
+#include <tuple> // For std::tie
 
 // Helper function to carve L-shaped paths
 // Static because it doesn't depend on MapGenerator instance members
 // Modified to carve a 1-tile wide path.
-static void carvePath(Grid<int>&map, Point p1, Point p2) {
+// 壁だけを通路の床にする（部屋の中を通るところは部屋の床のまま）
+// graph を渡すと、掘ったマスに通路番号 corridorId を記録する
+static void carvePath(TileGrid& map, Point p1, Point p2, RoomGraph* graph = nullptr, int32 corridorId = -1) {
 	Point current = p1;
+	const auto carve = [&](Point p) {
+		if (map[p] == Tile::Wall) map[p] = Tile::Floor;
+		if (graph) graph->corridorOfTile[p] = corridorId;
+	};
 
 	// Move horizontally from p1.x to p2.x at p1.y
 	while (current.x != p2.x) {
-		if (InRange(current.x, 0, MapGenerator::MAP_SIZE - 1) && InRange(current.y, 0, MapGenerator::MAP_SIZE - 1)) {
-			map[current.y][current.x] = 1; // Mark as floor/path
+		if (map.inBounds(current)) {
+			carve(current); // Mark as floor/path
 		}
 		current.x += (p2.x > current.x) ? 1 : -1;
 	}
 	// Ensure the junction point at (p2.x, p1.y) is also carved
-	if (InRange(current.x, 0, MapGenerator::MAP_SIZE - 1) && InRange(current.y, 0, MapGenerator::MAP_SIZE - 1)) {
-		map[current.y][current.x] = 1;
+	if (map.inBounds(current)) {
+		carve(current);
 	}
 
 	// Move vertically from p1.y to p2.y at p2.x
 	while (current.y != p2.y) {
-		if (InRange(current.x, 0, MapGenerator::MAP_SIZE - 1) && InRange(current.y, 0, MapGenerator::MAP_SIZE - 1)) {
-			map[current.y][current.x] = 1; // Mark as floor/path
+		if (map.inBounds(current)) {
+			carve(current); // Mark as floor/path
 		}
 		current.y += (p2.y > current.y) ? 1 : -1;
 	}
 	// Ensure the final destination p2 is also carved
-	if (InRange(current.x, 0, MapGenerator::MAP_SIZE - 1) && InRange(current.y, 0, MapGenerator::MAP_SIZE - 1)) {
-		map[current.y][current.x] = 1;
+	if (map.inBounds(current)) {
+		carve(current);
 	}
 }
 
+namespace {
+	// 部屋の連結成分を管理する素集合（経路圧縮＋サイズによる併合）
+	class DisjointSet {
+	public:
+		explicit DisjointSet(int32 size)
+			: m_parent(size), m_size(size, 1), m_count{ size } {
+			for (int32 i = 0; i < size; ++i) m_parent[i] = i;
+		}
+
+		int32 find(int32 i) {
+			while (m_parent[i] != i) {
+				m_parent[i] = m_parent[m_parent[i]];
+				i = m_parent[i];
+			}
+			return i;
+		}
+
+		bool same(int32 a, int32 b) { return find(a) == find(b); }
+
+		// 別々の集合だった場合だけ併合して true を返す
+		bool merge(int32 a, int32 b) {
+			a = find(a);
+			b = find(b);
+			if (a == b) return false;
+			if (m_size[a] < m_size[b]) std::swap(a, b);
+			m_parent[b] = a;
+			m_size[a] += m_size[b];
+			--m_count;
+			return true;
+		}
+
+		// 集合の数
+		int32 count() const { return m_count; }
+
+	private:
+		Array<int32> m_parent;
+		Array<int32> m_size;
+		int32 m_count;
+	};
+
+	// 既定サイズ：全ての大きさがコンパイル時定数になり、ループ境界などが畳み込まれる
+	struct FixedDimensions {
+		static constexpr int miniSize = MapGenerator::MINI_SIZE;
+		static constexpr int roomUnit = MapGenerator::ROOM_UNIT;
+		static constexpr int mapSize = MapGenerator::MAP_SIZE;
+		static constexpr int roomMargin = MapGenerator::RoomMargin(MapGenerator::ROOM_UNIT);
+	};
+
+	// 実行時に指定された大きさ
+	struct RuntimeDimensions {
+		int miniSize;
+		int roomUnit;
+		int mapSize;
+		int roomMargin;
+
+		explicit RuntimeDimensions(const MapConfig& config)
+			: miniSize{ config.miniSize }, roomUnit{ config.roomUnit }, mapSize{ config.mapSize() }, roomMargin{ MapGenerator::RoomMargin(config.roomUnit) } {}
+	};
+}
+
 // ミニマップ生成処理
 Array<Array<char>> MapGenerator::generateMiniMap() {
-	Array<Array<char>> miniMap(MINI_SIZE, Array<char>(MINI_SIZE, 'O')); // 初期はすべてO（空）
-	int roomCount = Random(5, 15); // ランダムに5〜15個の部屋を作成
+	if (m_config == MapConfig{}) {
+		return generateMiniMapImpl(FixedDimensions{});
+	}
+	return generateMiniMapImpl(RuntimeDimensions{ m_config });
+}
+
+// 実際のマップを生成する処理
+TileGrid MapGenerator::generateFullMap(const Array<Array<char>>& miniMap) {
+	if (m_config == MapConfig{}) {
+		return generateFullMapImpl(miniMap, FixedDimensions{});
+	}
+	return generateFullMapImpl(miniMap, RuntimeDimensions{ m_config });
+}
+
+template <class Dimensions>
+Array<Array<char>> MapGenerator::generateMiniMapImpl(const Dimensions& dims) {
+	Array<Array<char>> miniMap(dims.miniSize, Array<char>(dims.miniSize, 'O')); // 初期はすべてO（空）
+	// ミニマップのマス数の 1/5〜3/5 の部屋を作成（既定の 5x5 なら 5〜15 個）
+	const int cellCount = dims.miniSize * dims.miniSize;
+	// 小さなミニマップでも S と G の2部屋は必ず作る
+	int roomCount = Max(2, Random(cellCount / 5, cellCount * 3 / 5, m_rng));
 
 	// Rの部屋をランダムに配置
 	for (int i = 0; i < roomCount; ++i) {
 		while (true) {
-			int x = Random(0, MINI_SIZE - 1);
-			int y = Random(0, MINI_SIZE - 1);
+			int x = Random(0, dims.miniSize - 1, m_rng);
+			int y = Random(0, dims.miniSize - 1, m_rng);
 			if (miniMap[y][x] == 'O') {
 				miniMap[y][x] = 'R';
 				break;
@@ -53,76 +137,79 @@ Array<Array<char>> MapGenerator::generateMiniMap() {
 
 	// R部屋の中からランダムで2つ選び、SとGにする
 	Array<Point> roomPositions;
-	for (int y = 0; y < MINI_SIZE; ++y)
-		for (int x = 0; x < MINI_SIZE; ++x)
+	for (int y = 0; y < dims.miniSize; ++y)
+		for (int x = 0; x < dims.miniSize; ++x)
 			if (miniMap[y][x] == 'R')
 				roomPositions.push_back(Point{ x, y });
 
-	roomPositions.shuffle();
+	roomPositions.shuffle(m_rng);
 	miniMap[roomPositions[0].y][roomPositions[0].x] = 'S';
 	miniMap[roomPositions[1].y][roomPositions[1].x] = 'G';
 
 	return miniMap;
 }
 
-// 実際のマップを生成する処理
-Grid<int> MapGenerator::generateFullMap(const Array<Array<char>>& miniMap) {
+template <class Dimensions>
+TileGrid MapGenerator::generateFullMapImpl(const Array<Array<char>>& miniMap, const Dimensions& dims) {
 	startTile_generated.reset();
 	goalTile_generated.reset();
 	this->generatedRoomAreas.clear();
+	this->generatedRoomGraph.reset(Size{ dims.mapSize, dims.mapSize });
+	connectivityRepairCount = 0;
 
-	Grid<int> map(MAP_SIZE, MAP_SIZE, 0); // 初期状態はすべて通れないマス（0）
-	Array<Array<Optional<Room>>> rooms(MINI_SIZE, Array<Optional<Room>>(MINI_SIZE));
+	TileGrid map(dims.mapSize, dims.mapSize, Tile::Wall); // 初期状態はすべて壁
+	Array<Array<Optional<Room>>> rooms(dims.miniSize, Array<Optional<Room>>(dims.miniSize));
 
 	// 各ミニマップのマスを処理
-	for (int y = 0; y < MINI_SIZE; ++y) {
-		for (int x = 0; x < MINI_SIZE; ++x) {
+	for (int y = 0; y < dims.miniSize; ++y) {
+		for (int x = 0; x < dims.miniSize; ++x) {
 			char cell = miniMap[y][x];
 			if (cell == 'O') continue; // 空マスはスキップ
 
 			// 隣接する部屋に応じて余白（マージン）を設定
 			int marginL = 0, marginR = 0, marginT = 0, marginB = 0;
-			if (x > 0 && miniMap[y][x - 1] != 'O') marginL = 4;
-			if (x < MINI_SIZE - 1 && miniMap[y][x + 1] != 'O') marginR = 4;
-			if (y > 0 && miniMap[y - 1][x] != 'O') marginT = 4;
-			if (y < MINI_SIZE - 1 && miniMap[y + 1][x] != 'O') marginB = 4;
+			if (x > 0 && miniMap[y][x - 1] != 'O') marginL = dims.roomMargin;
+			if (x < dims.miniSize - 1 && miniMap[y][x + 1] != 'O') marginR = dims.roomMargin;
+			if (y > 0 && miniMap[y - 1][x] != 'O') marginT = dims.roomMargin;
+			if (y < dims.miniSize - 1 && miniMap[y + 1][x] != 'O') marginB = dims.roomMargin;
 
 			// 余白を考慮した配置可能な領域
-			int startX = x * ROOM_UNIT + marginL;
-			int startY = y * ROOM_UNIT + marginT;
-			int width = ROOM_UNIT - marginL - marginR;
-			int height = ROOM_UNIT - marginT - marginB;
+			int startX = x * dims.roomUnit + marginL;
+			int startY = y * dims.roomUnit + marginT;
+			int width = dims.roomUnit - marginL - marginR;
+			int height = dims.roomUnit - marginT - marginB;
 
-			// 部屋のサイズと位置をランダムで決定（最小辺3）
-			int roomW = Random(3, width);
-			int roomH = Random(3, height);
-			int offsetX = Random(0, width - roomW);
-			int offsetY = Random(0, height - roomH);
+			// 部屋のサイズと位置をランダムで決定（最小辺3。ClampConfig と RoomMargin により width, height は 3 以上）
+			int roomW = Random(3, width, m_rng);
+			int roomH = Random(3, height, m_rng);
+			int offsetX = Random(0, width - roomW, m_rng);
+			int offsetY = Random(0, height - roomH, m_rng);
 
 			Rect roomRect(startX + offsetX, startY + offsetY, roomW, roomH);
 
-			// マップ上に部屋を描画（1: 通れる）
+			// マップ上に部屋を描画（部屋の床）
 			for (int yy = roomRect.y; yy < roomRect.y + roomRect.h; ++yy)
 				for (int xx = roomRect.x; xx < roomRect.x + roomRect.w; ++xx)
-					map[yy][xx] = 1;
+					map[yy][xx] = Tile::DebugRoom;
 
 			// Add the generated room's rectangle to the list
 			this->generatedRoomAreas.push_back(roomRect);
+			this->generatedRoomGraph.addRoom(roomRect);
 
 			rooms[y][x] = Room{ roomRect, cell };
 		}
 	}
 
 	// 通路の生成処理
-	for (int y = 0; y < MINI_SIZE; ++y) {
-		for (int x = 0; x < MINI_SIZE; ++x) {
+	for (int y = 0; y < dims.miniSize; ++y) {
+		for (int x = 0; x < dims.miniSize; ++x) {
 			if (!rooms[y][x].has_value()) continue;
 			const Room& current = rooms[y][x].value();
 
 			// 上下左右の部屋と接続（SとGは接続しない）
 			for (auto [dx, dy] : Array<Point>{ {0, -1}, {0, 1}, {-1, 0}, {1, 0} }) {
 				int nx = x + dx, ny = y + dy;
-				if (InRange(nx, 0, MINI_SIZE - 1) && InRange(ny, 0, MINI_SIZE - 1)) {
+				if (InRange(nx, 0, dims.miniSize - 1) && InRange(ny, 0, dims.miniSize - 1)) {
 					if (rooms[ny][nx].has_value()) {
 						const Room& neighbor = rooms[ny][nx].value();
 
@@ -134,29 +221,31 @@ Grid<int> MapGenerator::generateFullMap(const Array<Array<char>>& miniMap) {
 						Point c1, c2;
 
 						if (dx == 1) { // Neighbor to the right
-							c1 = Point(current.area.x + current.area.w - 1, Random(current.area.y, current.area.y + current.area.h - 1));
-							c2 = Point(neighbor.area.x, Random(neighbor.area.y, neighbor.area.y + neighbor.area.h - 1));
+							c1 = Point(current.area.x + current.area.w - 1, Random(current.area.y, current.area.y + current.area.h - 1, m_rng));
+							c2 = Point(neighbor.area.x, Random(neighbor.area.y, neighbor.area.y + neighbor.area.h - 1, m_rng));
 						}
 						else if (dx == -1) { // Neighbor to the left
-							c1 = Point(current.area.x, Random(current.area.y, current.area.y + current.area.h - 1));
-							c2 = Point(neighbor.area.x + neighbor.area.w - 1, Random(neighbor.area.y, neighbor.area.y + neighbor.area.h - 1));
+							c1 = Point(current.area.x, Random(current.area.y, current.area.y + current.area.h - 1, m_rng));
+							c2 = Point(neighbor.area.x + neighbor.area.w - 1, Random(neighbor.area.y, neighbor.area.y + neighbor.area.h - 1, m_rng));
 						}
 						else if (dy == 1) { // Neighbor below
-							c1 = Point(Random(current.area.x, current.area.x + current.area.w - 1), current.area.y + current.area.h - 1);
-							c2 = Point(Random(neighbor.area.x, neighbor.area.x + neighbor.area.w - 1), neighbor.area.y);
+							c1 = Point(Random(current.area.x, current.area.x + current.area.w - 1, m_rng), current.area.y + current.area.h - 1);
+							c2 = Point(Random(neighbor.area.x, neighbor.area.x + neighbor.area.w - 1, m_rng), neighbor.area.y);
 						}
 						else { // dy == -1, Neighbor above
-							c1 = Point(Random(current.area.x, current.area.x + current.area.w - 1), current.area.y);
-							c2 = Point(Random(neighbor.area.x, neighbor.area.x + neighbor.area.w - 1), neighbor.area.y + neighbor.area.h - 1);
+							c1 = Point(Random(current.area.x, current.area.x + current.area.w - 1, m_rng), current.area.y);
+							c2 = Point(Random(neighbor.area.x, neighbor.area.x + neighbor.area.w - 1, m_rng), neighbor.area.y + neighbor.area.h - 1);
 						}
 
 						// Clamp points to map boundaries
-						c1.x = Clamp(c1.x, 0, MAP_SIZE - 1);
-						c1.y = Clamp(c1.y, 0, MAP_SIZE - 1);
-						c2.x = Clamp(c2.x, 0, MAP_SIZE - 1);
-						c2.y = Clamp(c2.y, 0, MAP_SIZE - 1);
-
-						carvePath(map, c1, c2);
+						c1.x = Clamp(c1.x, 0, dims.mapSize - 1);
+						c1.y = Clamp(c1.y, 0, dims.mapSize - 1);
+						c2.x = Clamp(c2.x, 0, dims.mapSize - 1);
+						c2.y = Clamp(c2.y, 0, dims.mapSize - 1);
+
+						// 通路を接続グラフに登録してから掘る
+						const int32 corridorId = generatedRoomGraph.addCorridor(generatedRoomGraph.roomAt(c1), c1, generatedRoomGraph.roomAt(c2), c2);
+						carvePath(map, c1, c2, &generatedRoomGraph, corridorId);
 					}
 				}
 			}
@@ -164,147 +253,85 @@ Grid<int> MapGenerator::generateFullMap(const Array<Array<char>>& miniMap) {
 	}
 
 	// --- BEGIN: Ensure all rooms are interconnected ---
-	// 連結性解析中にアクティブな部屋の情報を格納するためのヘルパー構造体。
-	struct RoomInfoInternal {
-		const Room* roomPtr;    // 実際のRoomオブジェクトへのポインタ。
-		Point miniMapPos;       // ミニマップグリッド上の元の位置（デバッグ/ログ用）。
-		int id;                 // この部屋の一意の識別子（activeRooms配列のインデックス）。
-	};
-
-	// ミニマップに実際に配置されたすべての部屋を収集する。
-	Array<RoomInfoInternal> activeRooms;
-	// ミニマップ座標(y,x)をactiveRooms内の部屋のID（インデックス）に迅速にマッピングするためのグリッド。
-	Grid<Optional<int>> roomMiniMapToActiveID(MINI_SIZE, MINI_SIZE);
-
-	for (int y = 0; y < MINI_SIZE; ++y) {
-		for (int x = 0; x < MINI_SIZE; ++x) {
+	// 部屋番号は generatedRoomGraph と同じ（ミニマップを行優先で走査した順）
+	Array<Point> roomCells;                                           // 部屋番号 → ミニマップ座標
+	Grid<int32> roomIdOfCell(dims.miniSize, dims.miniSize, -1);        // ミニマップ座標 → 部屋番号
+	for (int y = 0; y < dims.miniSize; ++y) {
+		for (int x = 0; x < dims.miniSize; ++x) {
 			if (rooms[y][x].has_value()) {
-				int currentId = static_cast<int>(activeRooms.size());
-				activeRooms.push_back(RoomInfoInternal{ &rooms[y][x].value(), Point(x,y), currentId });
-				roomMiniMapToActiveID[y][x] = currentId;
+				roomIdOfCell[y][x] = static_cast<int32>(roomCells.size());
+				roomCells << Point{ x, y };
 			}
 		}
 	}
 
-	if (activeRooms.isEmpty()) {
-		Console << U"Warning: No active rooms found to interconnect.";
-	}
-	else {
-		// 初期の通路によって接続された部屋のグラフを表す隣接リストを構築する。
-		Array<Array<int>> roomAdjList(activeRooms.size());
-		// アクティブな部屋を反復処理して、最初の通路生成フェーズでどの部屋が接続されたかを確認する。
-		for (int y = 0; y < MINI_SIZE; ++y) {
-			for (int x = 0; x < MINI_SIZE; ++x) {
-				if (!rooms[y][x].has_value()) continue; // ここに部屋がなければスキップ
-				int currentRoomActiveId = roomMiniMapToActiveID[y][x].value();
-				const Room& currentRoomData = rooms[y][x].value();
-
-				// 接続の二重カウントを避け、自己ループを防ぐため、隣接チェックは右と下方向の隣人のみ行う。
-				for (auto [dx, dy] : Array<Point>{ {1, 0}, {0, 1} }) {
-					int nx = x + dx;
-					int ny = y + dy;
-					if (InRange(nx, 0, MINI_SIZE - 1) && InRange(ny, 0, MINI_SIZE - 1)) {
-						if (rooms[ny][nx].has_value()) {
-							const Room& neighborRoomData = rooms[ny][nx].value();
-							// Check S-G rule again, as original loop did
-							if (!((currentRoomData.type == 'S' && neighborRoomData.type == 'G') ||
-								(currentRoomData.type == 'G' && neighborRoomData.type == 'S'))) {
-								int neighborRoomActiveId = roomMiniMapToActiveID[ny][nx].value();
-								roomAdjList[currentRoomActiveId].push_back(neighborRoomActiveId);
-								roomAdjList[neighborRoomActiveId].push_back(currentRoomActiveId);
-							}
-						}
-					}
-				}
-			}
+	// 最初の通路で繋がった部屋どうしを併合する
+	DisjointSet roomSets(static_cast<int32>(roomCells.size()));
+	for (const auto& corridor : generatedRoomGraph.corridors) {
+		if (corridor.roomA >= 0 && corridor.roomB >= 0) {
+			roomSets.merge(corridor.roomA, corridor.roomB);
 		}
+	}
 
-		// 隣接リストのクリーンアップ：ソートし、対称的なpush_backによって発生する可能性のある重複を削除する。
-		for (auto& adj : roomAdjList) {
-			adj.sort_and_unique();
-		}
+	// まだ繋がっていなければ、ミニマップ上の探索半径を倍々に広げながら近い部屋の組を候補にし、
+	// 中心間の距離が短い順に別の集合どうしを繋ぐ（クラスカル法）
+	// 半径 prevRadius 以内の組は前の段階で全て同じ集合になっているので、各段階では外周だけを調べればよい
+	struct RepairCandidate {
+		int32 distanceSq;
+		int32 roomA;
+		int32 roomB;
+	};
+	Array<RepairCandidate> candidates;
+	const auto roomCenter = [&](int32 roomId) {
+		const Point cell = roomCells[roomId];
+		Point center = rooms[cell.y][cell.x].value().area.center().asPoint();
+		center.x = Clamp(center.x, 0, dims.mapSize - 1);
+		center.y = Clamp(center.y, 0, dims.mapSize - 1);
+		return center;
+	};
 
-		// 部屋グラフ上でBFSを使用して、連結された部屋のコンポーネントを特定する。
-		Array<int> roomComponent(activeRooms.size(), -1); // 各部屋のコンポーネントIDを格納する。
-		int totalComponents = 0;                          // 個別のコンポーネントのカウンター。
-		for (int i = 0; i < activeRooms.size(); ++i) {
-			if (roomComponent[i] == -1) { // まだ部屋 'i' がコンポーネントに割り当てられていない場合
-				totalComponents++;
-				std::queue<int> component_q; // BFS用のキュー
-				component_q.push(i);
-				roomComponent[i] = totalComponents; // 新しいコンポーネントIDを割り当てる
-				// このコンポーネント内のすべての部屋を見つけるためにBFSを実行する
-				while (!component_q.empty()) {
-					int u = component_q.front();
-					component_q.pop();
-					for (int v : roomAdjList[u]) {
-						if (roomComponent[v] == -1) {
-							roomComponent[v] = totalComponents;
-							component_q.push(v);
-						}
-					}
+	for (int32 prevRadius = 0, radius = 1; (roomSets.count() > 1) && (prevRadius < dims.miniSize); prevRadius = radius, radius *= 2) {
+		candidates.clear();
+		for (int32 roomA = 0; roomA < static_cast<int32>(roomCells.size()); ++roomA) {
+			const Point cell = roomCells[roomA];
+			for (int32 dy = -radius; dy <= radius; ++dy) {
+				const int32 ny = cell.y + dy;
+				if (!InRange(ny, 0, dims.miniSize - 1)) continue;
+				for (int32 dx = -radius; dx <= radius; ++dx) {
+					if (Max(Abs(dx), Abs(dy)) <= prevRadius) continue; // 内側は調べ済み
+					const int32 nx = cell.x + dx;
+					if (!InRange(nx, 0, dims.miniSize - 1)) continue;
+					const int32 roomB = roomIdOfCell[ny][nx];
+					if ((roomB <= roomA) || roomSets.same(roomA, roomB)) continue; // 組は (小さい番号, 大きい番号) の1回だけ数える
+					const Point d = roomCenter(roomA) - roomCenter(roomB);
+					candidates << RepairCandidate{ d.x * d.x + d.y * d.y, roomA, roomB };
 				}
 			}
 		}
 
-		// 部屋の連結されていないコンポーネントが複数存在する場合、それらを接続する。
-		if (totalComponents > 1) {
-			//Console << Format(U"複数の部屋コンポーネントが検出されました（{}）。接続を試みます。")(totalComponents);
-			// 最初のアクティブな部屋のコンポーネントをメインコンポーネントとして指定する。
-			// (または、簡単に見分けられるならスタート部屋のコンポーネント)
-			int mainComponentID = roomComponent[0];
-
-			// 見つかった他のすべてのコンポーネントIDを反復処理する。
-			for (int currentCompID = 1; currentCompID <= totalComponents; ++currentCompID) {
-				if (currentCompID == mainComponentID) continue; // メインコンポーネント自体ならスキップ
-
-				double minDistance = Math::Inf;
-				// activeRooms配列内の{メインコンポーネントのインデックス, 現在のコンポーネントのインデックス}を格納する
-				s3d::Optional<std::pair<int, int>> closestPairActiveIndices;
-
-				// 最も近いペアの部屋を見つける：一方はmainComponentIDから、もう一方はcurrentCompIDから。
-				for (int i = 0; i < activeRooms.size(); ++i) {
-					if (roomComponent[i] == mainComponentID) {
-						for (int j = 0; j < activeRooms.size(); ++j) {
-							if (roomComponent[j] == currentCompID) {
-								Point center1 = activeRooms[i].roomPtr->area.center().asPoint();
-								Point center2 = activeRooms[j].roomPtr->area.center().asPoint();
-								double dist = center1.distanceFrom(center2);
-								if (dist < minDistance) {
-									minDistance = dist;
-									closestPairActiveIndices.emplace(i, j);
-								}
-							}
-						}
-					}
-				}
+		std::sort(candidates.begin(), candidates.end(), [](const RepairCandidate& a, const RepairCandidate& b) {
+			return std::tie(a.distanceSq, a.roomA, a.roomB) < std::tie(b.distanceSq, b.roomA, b.roomB);
+		});
 
-				// 最も近いペアが見つかった場合、それらを接続する。
-				if (closestPairActiveIndices.has_value()) {
-					int roomIdx1 = closestPairActiveIndices.value().first;
-					int roomIdx2 = closestPairActiveIndices.value().second;
+		for (const auto& candidate : candidates) {
+			if (!roomSets.merge(candidate.roomA, candidate.roomB)) continue; // 既に繋がっている
 
-					Point p1 = activeRooms[roomIdx1].roomPtr->area.center().asPoint();
-					Point p2 = activeRooms[roomIdx2].roomPtr->area.center().asPoint();
+			const Point p1 = roomCenter(candidate.roomA);
+			const Point p2 = roomCenter(candidate.roomB);
+			const int32 corridorId = generatedRoomGraph.addCorridor(candidate.roomA, p1, candidate.roomB, p2);
+			carvePath(map, p1, p2, &generatedRoomGraph, corridorId); // 実際のタイルマップに経路を掘ることでそれらを接続する。
+			++connectivityRepairCount;
 
-					// Clamp points before carving path, just in case room centers are at edge
-					p1.x = Clamp(p1.x, 0, MAP_SIZE - 1); p1.y = Clamp(p1.y, 0, MAP_SIZE - 1);
-					p2.x = Clamp(p2.x, 0, MAP_SIZE - 1); p2.y = Clamp(p2.y, 0, MAP_SIZE - 1);
-
-					carvePath(map, p1, p2); // 実際のタイルマップに経路を掘ることでそれらを接続する。
-					//Console << Format(U"Forcibly connecting room {} (comp {}) to room {} (comp {}).")(activeRooms[roomIdx1].miniMapPos, roomComponent[roomIdx1], activeRooms[roomIdx2].miniMapPos, roomComponent[roomIdx2]);
-					// この簡略化されたアプローチでは、ここではroomComponent配列内のコンポーネントIDを明示的にマージしない。
-					// 物理的な経路が存在することを確認するだけ。後のS-G BFSがこれらの新しい経路を使用する。
-				}
-			}
+			if (roomSets.count() == 1) break;
 		}
 	}
 	// --- END: Ensure all rooms are interconnected ---
+	// 全ての部屋が1つの集合になったので、S と G もタイル上で繋がっている（マスの BFS による確認は不要）
 
-	// S-G Connectivity Check and Enforcement
+	// S と G の部屋を探す
 	Optional<Room> sRoomOpt, gRoomOpt;
-	for (int y = 0; y < MINI_SIZE; ++y) {
-		for (int x = 0; x < MINI_SIZE; ++x) {
+	for (int y = 0; y < dims.miniSize; ++y) {
+		for (int x = 0; x < dims.miniSize; ++x) {
 			if (rooms[y][x].has_value()) {
 				if (rooms[y][x].value().type == 'S') {
 					sRoomOpt = rooms[y][x].value();
@@ -328,89 +355,16 @@ Grid<int> MapGenerator::generateFullMap(const Array<Array<char>>& miniMap) {
 	// Using .tl() (top-left) as it's a defined point of the room's Rect.
 	// Clamping to ensure they are within map boundaries.
 	Point sPos = sRoomOpt.value().area.tl();
-	sPos.x = Clamp(sPos.x, 0, MAP_SIZE - 1);
-	sPos.y = Clamp(sPos.y, 0, MAP_SIZE - 1);
+	sPos.x = Clamp(sPos.x, 0, dims.mapSize - 1);
+	sPos.y = Clamp(sPos.y, 0, dims.mapSize - 1);
 	startTile_generated = sPos;
 
 	Point gPos = gRoomOpt.value().area.tl();
-	gPos.x = Clamp(gPos.x, 0, MAP_SIZE - 1);
-	gPos.y = Clamp(gPos.y, 0, MAP_SIZE - 1);
+	gPos.x = Clamp(gPos.x, 0, dims.mapSize - 1);
+	gPos.y = Clamp(gPos.y, 0, dims.mapSize - 1);
 	goalTile_generated = gPos;
 
-	const Room& sRoom = sRoomOpt.value();
-	const Room& gRoom = gRoomOpt.value();
-	bool s_g_connected = false;
-
-	Grid<bool> visited(MAP_SIZE, MAP_SIZE, false);
-	std::queue<Point> q;
-
-	Optional<Point> bfsStartPointOpt;
-	Point sRoomCenter = sRoom.area.center().asPoint();
-	// Clamp sRoomCenter to be within map bounds before accessing map with it
-	sRoomCenter.x = Clamp(sRoomCenter.x, 0, MAP_SIZE - 1);
-	sRoomCenter.y = Clamp(sRoomCenter.y, 0, MAP_SIZE - 1);
-
-	if (map[sRoomCenter.y][sRoomCenter.x] == 1) {
-		bfsStartPointOpt = sRoomCenter;
-	}
-	else {
-		// Iterate through all tiles in sRoom.area to find a passable tile
-		for (int ry = sRoom.area.y; ry < sRoom.area.y + sRoom.area.h; ++ry) {
-			for (int rx = sRoom.area.x; rx < sRoom.area.x + sRoom.area.w; ++rx) {
-				Point currentTile(Clamp(rx, 0, MAP_SIZE - 1), Clamp(ry, 0, MAP_SIZE - 1));
-				if (map[currentTile.y][currentTile.x] == 1) {
-					bfsStartPointOpt = currentTile;
-					goto found_passable_start_tile; // Exit nested loops
-				}
-			}
-		}
-	found_passable_start_tile:;
-	}
-
-	if (!bfsStartPointOpt.has_value()) {
-		Console << U"Error: No passable tile found in Start ('S') room. Cannot perform BFS.";
-		// Proceed to force connection as they are considered disconnected
-	}
-	else {
-		Point startTile = bfsStartPointOpt.value();
-		q.push(startTile);
-		visited[startTile.y][startTile.x] = true;
-
-		Point DIRS[] = { {0, -1}, {0, 1}, {-1, 0}, {1, 0} }; // N, S, W, E
-
-		while (!q.empty()) {
-			Point current = q.front();
-			q.pop();
-
-			if (gRoom.area.contains(current)) {
-				s_g_connected = true;
-				break;
-			}
-
-			for (const auto& dir : DIRS) {
-				Point next = current + dir;
-				if (InRange(next.x, 0, MAP_SIZE - 1) && InRange(next.y, 0, MAP_SIZE - 1) &&
-					map[next.y][next.x] == 1 && !visited[next.y][next.x]) {
-					visited[next.y][next.x] = true;
-					q.push(next);
-				}
-			}
-		}
-	}
-
-	if (!s_g_connected) {
-		Console << U"S and G not connected. Forcing connection.";
-		Point sCenter = sRoom.area.center().asPoint();
-		Point gCenter = gRoom.area.center().asPoint();
-
-		// Clamp points to map boundaries before carving path
-		sCenter.x = Clamp(sCenter.x, 0, MAP_SIZE - 1);
-		sCenter.y = Clamp(sCenter.y, 0, MAP_SIZE - 1);
-		gCenter.x = Clamp(gCenter.x, 0, MAP_SIZE - 1);
-		gCenter.y = Clamp(gCenter.y, 0, MAP_SIZE - 1);
-
-		carvePath(map, sCenter, gCenter);
-	}
-
+	map[sPos] = Tile::Start;
+	map[gPos] = Tile::Goal;
 	return map;
 }
@@ -1,24 +1,88 @@
 ﻿#pragma once
-#include <Siv3D.hpp>
+# include "Common.hpp"
+#include "RoomGraph.hpp"
+#include "Tile.hpp"
+
+// マップ生成に使う乱数エンジン（既定は小さくて速い xoshiro256++。差し替えるときはここを変える）
+using MapRNG = DefaultRNG;
 
 class MapGenerator
 {
 public:
-	static constexpr int MINI_SIZE = 5;     // ミニマップのサイズ（5x5）
-	static constexpr int MAP_SIZE = 50;     // フルマップのサイズ（50x50）
-	static constexpr int ROOM_UNIT = 10;    // ミニマップ1マスに対応する部屋サイズ（10x10）
+	// 既定の大きさ（この大きさの時はコンパイル時定数のまま生成する）
+	static constexpr int MINI_SIZE = MapConfig{}.miniSize;    // ミニマップのサイズ（5x5）
+	static constexpr int MAP_SIZE = MapConfig{}.mapSize();    // フルマップのサイズ（50x50）
+	static constexpr int ROOM_UNIT = MapConfig{}.roomUnit;    // ミニマップ1マスに対応する部屋サイズ（10x10）
+
+	// 生成できる最小の大きさ
+	// ミニマップは S と G の2部屋が入るように 2 以上
+	// 部屋の一辺は、隣の部屋との間に壁を 1 マスずつ残しても最小辺 3 の部屋が入るように 5 以上
+	static constexpr int MIN_MINI_SIZE = 2;
+	static constexpr int MIN_ROOM_UNIT = 3 + 1 * 2;
+
+	// 隣に部屋があるときに空ける余白（4 マス。部屋の一辺が小さく、両側に余白を取ると最小辺 3 の部屋が入らなければ狭める）
+	static constexpr int RoomMargin(int roomUnit) { return Min(4, (roomUnit - 3) / 2); }
+
+	// 大きさを生成できる範囲に収める（小さすぎる値は最小値にする）
+	static constexpr MapConfig ClampConfig(const MapConfig& config) {
+		return MapConfig{ Max(config.miniSize, MIN_MINI_SIZE), Max(config.roomUnit, MIN_ROOM_UNIT) };
+	}
+
+	MapGenerator() = default;
+	explicit MapGenerator(const MapConfig& config) : m_config{ ClampConfig(config) } {}
+	MapGenerator(const MapConfig& config, uint64 seed) : m_config{ ClampConfig(config) } { setSeed(seed); }
+
+	// 乱数のシードを設定する
+	// setSeed の直後に generateMiniMap → generateFullMap を呼べば、同じシードからは常に同じフロアができる
+	void setSeed(uint64 seed) { m_seed = seed; m_rng.seed(seed); }
+	uint64 getSeed() const { return m_seed; }
+
+	// 生成に使っている乱数エンジン（敵の配置など、フロアと一緒に再現したい乱数にも使う）
+	MapRNG& rng() { return m_rng; }
+
+	// 1回のプレイのシードと階層から、その階のシードを作る（SplitMix64 の混ぜ合わせ）
+	static constexpr uint64 FloorSeed(uint64 runSeed, int32 floor) {
+		uint64 z = runSeed + (static_cast<uint64>(floor) + 1) * 0x9E3779B97F4A7C15ull;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	// 生成するマップの大きさを変える（ClampConfig で生成できる範囲に収める）
+	void setConfig(const MapConfig& config) { m_config = ClampConfig(config); }
+	const MapConfig& getConfig() const { return m_config; }
+
+	int32 miniSize() const { return m_config.miniSize; }
+	int32 mapSize() const { return m_config.mapSize(); }
+	int32 roomUnit() const { return m_config.roomUnit; }
 
 	// ミニマップを生成する関数
 	Array<Array<char>> generateMiniMap();
 
 	// フルマップ（実マップ）を生成する関数
-	Grid<int> generateFullMap(const Array<Array<char>>& miniMap);
+	// 部屋は DebugRoom、通路は Floor、スタートとゴールのマスは Start / Goal にした、そのままゲームで使える地形を返す
+	TileGrid generateFullMap(const Array<Array<char>>& miniMap);
 
 	Optional<Point> startTile_generated;
 	Optional<Point> goalTile_generated;
 	Array<Rect> generatedRoomAreas;
+	// 部屋と通路の接続グラフ（階層的な経路探索用に generateFullMap が出力する）
+	RoomGraph generatedRoomGraph;
+	// 離れた部屋どうしを繋ぐために追加で掘った通路の数
+	int32 connectivityRepairCount = 0;
 
 private:
+	// Dimensions は大きさの取り出し方（既定サイズなら定数、それ以外は m_config の値）
+	template <class Dimensions>
+	Array<Array<char>> generateMiniMapImpl(const Dimensions& dims);
+
+	template <class Dimensions>
+	TileGrid generateFullMapImpl(const Array<Array<char>>& miniMap, const Dimensions& dims);
+
+	MapConfig m_config;
+	uint64 m_seed = RandomUint64();
+	MapRNG m_rng{ m_seed };
+
 	// 各部屋の情報を格納する構造体a
 	struct Room {
 		Rect area;   // 部屋の矩形領域
@@ -0,0 +1,42 @@
+﻿#pragma once
+# include "Common.hpp"
+
+// マスの上にいるキャラクター（プレイヤーと敵）
+// 地形（currentMapGrid）とは別に持つので、移動で地形を書き換えたり元に戻したりする必要がない
+class OccupancyGrid {
+public:
+	static constexpr int32 NoEnemy = -1;
+
+	void reset(Size mapSize) {
+		m_enemyIndex.assign(mapSize.x, mapSize.y, NoEnemy);
+		m_player = Point{ -1, -1 };
+	}
+
+	bool hasEnemy(Point p) const { return m_enemyIndex.inBounds(p) && (m_enemyIndex[p] != NoEnemy); }
+	bool hasPlayer(Point p) const { return p == m_player; }
+	// 誰かがいるマス（敵の移動先にはできない）
+	bool isOccupied(Point p) const { return hasPlayer(p) || hasEnemy(p); }
+
+	// p にいる敵の番号（EnemyStore の添字）。マスを引くだけなので敵の数によらない
+	Optional<size_t> enemyAt(Point p) const {
+		if (!hasEnemy(p)) return none;
+		return static_cast<size_t>(m_enemyIndex[p]);
+	}
+
+	// 番号が変わったとき（入れ替えによる削除）も、同じマスに置き直せばよい
+	void placeEnemy(Point p, size_t index) { if (m_enemyIndex.inBounds(p)) m_enemyIndex[p] = static_cast<int32>(index); }
+	void removeEnemy(Point p) { if (m_enemyIndex.inBounds(p)) m_enemyIndex[p] = NoEnemy; }
+	void moveEnemy(Point from, Point to) {
+		if (!hasEnemy(from)) return;
+		const size_t index = static_cast<size_t>(m_enemyIndex[from]);
+		removeEnemy(from);
+		placeEnemy(to, index);
+	}
+
+	void setPlayer(Point p) { m_player = p; }
+	Point getPlayer() const { return m_player; }
+
+private:
+	Grid<int32> m_enemyIndex;      // そのマスにいる敵の番号（いなければ NoEnemy）
+	Point m_player{ -1, -1 };
+};
@@ -0,0 +1,434 @@
+﻿
+#include "PathFinder.hpp"
+
+namespace {
+	// 8方向の移動量（並びは通れるマスの表の周囲マスクと同じ）
+	constexpr auto& Directions = WalkableBitboard::Directions;
+}
+
+uint8 PathFinder::terrainNeighborMask(const TileGrid& mapData, Point p) const {
+	if (m_walkable) return m_walkable->neighborMask(p);
+
+	uint8 mask = 0;
+	for (size_t i = 0; i < std::size(Directions); ++i) {
+		const Point neighbor = p + Directions[i];
+		if (mapData.inBounds(neighbor) && IsPassable(mapData[neighbor])) {
+			mask |= static_cast<uint8>(1u << i);
+		}
+	}
+	return mask;
+}
+
+void PathFinder::reserve(Size mapSize) {
+	if (mapSize.x == m_width && mapSize.y == m_height) return;
+
+	m_width = mapSize.x;
+	m_height = mapSize.y;
+
+	const size_t cellCount = static_cast<size_t>(m_width) * m_height;
+	m_openedGen.assign(cellCount, 0);
+	m_closedGen.assign(cellCount, 0);
+	m_gScore.assign(cellCount, 0);
+	m_parent.assign(cellCount, -1);
+
+	// 重複登録を許すので、マス数の数倍までは再確保なしで積めるようにしておく
+	m_heap.clear();
+	m_heap.reserve(cellCount * 2);
+
+	m_generation = 0;
+}
+
+void PathFinder::beginSearch() {
+	m_heap.clear();
+	++m_generation;
+
+	// 世代番号が一周したら作業配列を消し直す（めったに起きない）
+	if (m_generation == 0) {
+		std::fill(m_openedGen.begin(), m_openedGen.end(), 0);
+		std::fill(m_closedGen.begin(), m_closedGen.end(), 0);
+		m_generation = 1;
+	}
+}
+
+bool PathFinder::HeapLess(const HeapNode& a, const HeapNode& b) {
+	if (a.f != b.f) return a.f < b.f;
+	return a.g > b.g;
+}
+
+void PathFinder::heapPush(const HeapNode& node) {
+	m_heap.push_back(node);
+
+	size_t i = m_heap.size() - 1;
+	while (i > 0) {
+		const size_t parent = (i - 1) / 2;
+		if (!HeapLess(m_heap[i], m_heap[parent])) break;
+		std::swap(m_heap[i], m_heap[parent]);
+		i = parent;
+	}
+}
+
+PathFinder::HeapNode PathFinder::heapPop() {
+	const HeapNode top = m_heap.front();
+	m_heap.front() = m_heap.back();
+	m_heap.pop_back();
+
+	const size_t size = m_heap.size();
+	size_t i = 0;
+	while (true) {
+		const size_t left = i * 2 + 1;
+		const size_t right = left + 1;
+		size_t smallest = i;
+		if (left < size && HeapLess(m_heap[left], m_heap[smallest])) smallest = left;
+		if (right < size && HeapLess(m_heap[right], m_heap[smallest])) smallest = right;
+		if (smallest == i) break;
+		std::swap(m_heap[i], m_heap[smallest]);
+		i = smallest;
+	}
+
+	return top;
+}
+
+void PathFinder::pushStart(Point start, Point goal) {
+	const int32 startIndex = toIndex(start);
+	m_openedGen[startIndex] = m_generation;
+	m_gScore[startIndex] = 0;
+	m_parent[startIndex] = -1;
+	heapPush(HeapNode{ Heuristic(start, goal), 0, startIndex });
+}
+
+bool PathFinder::relax(int32 index, int32 parentIndex, int32 g, Point goal) {
+	if (m_closedGen[index] == m_generation) return false;
+	if (m_openedGen[index] == m_generation && m_gScore[index] <= g) return false;
+
+	m_openedGen[index] = m_generation;
+	m_gScore[index] = g;
+	m_parent[index] = parentIndex;
+	heapPush(HeapNode{ g + Heuristic(toPoint(index), goal), g, index });
+	return true;
+}
+
+void PathFinder::buildRoute(int32 goalIndex, Array<Point>& route) const {
+	for (int32 i = goalIndex; i != -1; i = m_parent[i]) {
+		const Point p = toPoint(i);
+		route << p;
+
+		// JPS の親は直線か斜めの延長線上にあるので、その間を1マスずつ埋める
+		if (m_parent[i] != -1) {
+			const Point parent = toPoint(m_parent[i]);
+			const Point step{ (parent.x > p.x) - (parent.x < p.x), (parent.y > p.y) - (parent.y < p.y) };
+			for (Point q = p + step; q != parent; q += step) {
+				route << q;
+			}
+		}
+	}
+	std::reverse(route.begin(), route.end());
+}
+
+template <class Trace>
+bool PathFinder::findPath(Point start, Point goal, const TileGrid& mapData, const OccupancyGrid& occupancy, Array<Point>& route, Trace& trace) {
+	route.clear();
+	trace.clear();
+	m_occupancy = &occupancy;
+
+	reserve(mapData.size());
+	if (!mapData.inBounds(start) || !mapData.inBounds(goal)) return false;
+
+	m_bounds = Rect{ 0, 0, m_width, m_height };
+
+	// 壁や誰かのいるマスはどの方式でも辿り着けないので、探索を始める前に断る
+	if (!IsWalkable(mapData, goal)) return false;
+
+	PathSearchMode localMode = m_mode;
+	Point localGoal = goal;
+
+	// 階層モード：部屋グラフで次の中継点を決め、そこまでを囲む狭い範囲だけを探索する
+	if (m_mode == PathSearchMode::Hierarchical) {
+		localMode = PathSearchMode::JumpPoint;
+		if (m_roomGraph) {
+			// 部屋グラフで繋がらなければ到達できない（マップ全体の探索に切り替えると、このモードを使う大きなマップで遅くなる）
+			const auto waypoint = planNextWaypoint(start, goal);
+			if (!waypoint) return false;
+
+			localGoal = *waypoint;
+			const int32 left = Max(Min(start.x, localGoal.x) - LocalSearchMargin, 0);
+			const int32 top = Max(Min(start.y, localGoal.y) - LocalSearchMargin, 0);
+			const int32 right = Min(Max(start.x, localGoal.x) + LocalSearchMargin, m_width - 1);
+			const int32 bottom = Min(Max(start.y, localGoal.y) + LocalSearchMargin, m_height - 1);
+			m_bounds = Rect{ left, top, right - left + 1, bottom - top + 1 };
+		}
+	}
+
+	beginSearch();
+	pushStart(start, localGoal);
+
+	const bool found = (localMode == PathSearchMode::JumpPoint)
+		? searchJumpPoint(start, localGoal, mapData, trace)
+		: searchAStar(start, localGoal, mapData, trace);
+
+	if (found) {
+		buildRoute(toIndex(localGoal), route);
+	}
+	return found;
+}
+
+Optional<Point> PathFinder::planNextWaypoint(Point start, Point goal) {
+	const RoomGraph& graph = *m_roomGraph;
+
+	// マスが属する場所（部屋を優先し、部屋の外なら通路）
+	const int32 startRoom = graph.roomAt(start);
+	const int32 startCorridor = (startRoom == -1) ? graph.corridorAt(start) : -1;
+	const int32 goalRoom = graph.roomAt(goal);
+	const int32 goalCorridor = (goalRoom == -1) ? graph.corridorAt(goal) : -1;
+
+	if ((startRoom == -1 && startCorridor == -1) || (goalRoom == -1 && goalCorridor == -1)) return none;
+
+	// 同じ部屋・同じ通路の中なら中継点は不要
+	if ((startRoom != -1 && startRoom == goalRoom) || (startCorridor != -1 && startCorridor == goalCorridor)) return goal;
+
+	const int32 doorCount = static_cast<int32>(graph.corridors.size()) * 2;
+	const int32 startNode = doorCount;
+	const int32 goalNode = doorCount + 1;
+	const size_t nodeCount = static_cast<size_t>(doorCount) + 2;
+
+	if (m_nodeGen.size() < nodeCount) {
+		m_nodeGen.resize(nodeCount, 0);
+		m_nodeCost.resize(nodeCount, 0);
+		m_nodeParent.resize(nodeCount, -1);
+	}
+	if (++m_nodeGeneration == 0) {
+		std::fill(m_nodeGen.begin(), m_nodeGen.end(), 0);
+		m_nodeGeneration = 1;
+	}
+	m_nodeHeap.clear();
+
+	const auto doorPos = [&](int32 node) {
+		const auto& corridor = graph.corridors[node / 2];
+		return (node % 2 == 0) ? corridor.doorA : corridor.doorB;
+	};
+	const auto nodePos = [&](int32 node) {
+		return (node == startNode) ? start : (node == goalNode) ? goal : doorPos(node);
+	};
+	// 部屋の中は障害物の無い矩形なのでチェビシェフ距離がそのまま歩数になる。通路は縦横の差の和で見積もる
+	const auto areaCost = [&](int32 room, Point a, Point b) {
+		return (room != -1) ? Heuristic(a, b) : (Abs(a.x - b.x) + Abs(a.y - b.y));
+	};
+	const auto push = [&](int32 node, int32 parent, int32 cost) {
+		if (m_nodeGen[node] == m_nodeGeneration && m_nodeCost[node] <= cost) return;
+		m_nodeGen[node] = m_nodeGeneration;
+		m_nodeCost[node] = cost;
+		m_nodeParent[node] = parent;
+		m_nodeHeap.push_back(HeapNode{ cost + Heuristic(nodePos(node), goal), cost, node });
+		std::push_heap(m_nodeHeap.begin(), m_nodeHeap.end(), [](const HeapNode& a, const HeapNode& b) { return HeapLess(b, a); });
+	};
+	// 部屋か通路に接する出入口ノードを列挙する
+	const auto forEachDoor = [&](int32 room, int32 corridor, auto&& fn) {
+		if (room != -1) {
+			for (const int32 k : graph.roomCorridors[room]) {
+				fn(k * 2 + ((graph.corridors[k].roomA == room) ? 0 : 1));
+			}
+		}
+		else {
+			fn(corridor * 2);
+			fn(corridor * 2 + 1);
+		}
+	};
+
+	push(startNode, -1, 0);
+
+	while (!m_nodeHeap.isEmpty()) {
+		std::pop_heap(m_nodeHeap.begin(), m_nodeHeap.end(), [](const HeapNode& a, const HeapNode& b) { return HeapLess(b, a); });
+		const HeapNode current = m_nodeHeap.back();
+		m_nodeHeap.pop_back();
+
+		// 登録し直された古い要素は読み飛ばす
+		if (current.g != m_nodeCost[current.index]) continue;
+
+		const int32 node = current.index;
+		if (node == goalNode) {
+			// 始点の次の出入口を中継点にする（始点がちょうど出入口の上なら、その次）
+			m_nodePath.clear();
+			for (int32 n = goalNode; n != startNode; n = m_nodeParent[n]) {
+				m_nodePath << n;
+			}
+			for (auto it = m_nodePath.rbegin(); it != m_nodePath.rend(); ++it) {
+				const Point waypoint = nodePos(*it);
+				if (waypoint != start) return waypoint;
+			}
+			return goal;
+		}
+
+		if (node == startNode) {
+			forEachDoor(startRoom, startCorridor, [&](int32 door) {
+				push(door, node, current.g + areaCost(startRoom, start, doorPos(door)));
+			});
+			continue;
+		}
+
+		const int32 corridorId = node / 2;
+		const auto& corridor = graph.corridors[corridorId];
+		const Point door = doorPos(node);
+		const int32 room = (node % 2 == 0) ? corridor.roomA : corridor.roomB;
+
+		// 通路を反対側の出入口まで通り抜ける
+		push(node ^ 1, node, current.g + corridor.cost);
+
+		// 同じ部屋の別の出入口へ
+		if (room != -1) {
+			forEachDoor(room, -1, [&](int32 other) {
+				if (other != node) push(other, node, current.g + Heuristic(door, doorPos(other)));
+			});
+		}
+
+		// 終点のある部屋・通路に着いたら終点へ
+		if (room != -1 && room == goalRoom) {
+			push(goalNode, node, current.g + Heuristic(door, goal));
+		}
+		else if (corridorId == goalCorridor) {
+			push(goalNode, node, current.g + areaCost(-1, door, goal));
+		}
+	}
+
+	return none;
+}
+
+template <class Trace>
+bool PathFinder::searchAStar(Point, Point goal, const TileGrid& mapData, Trace& trace) {
+	const int32 goalIndex = toIndex(goal);
+
+	while (!m_heap.isEmpty()) {
+		const HeapNode current = heapPop();
+
+		// 既に確定したマス（より良いコストで登録し直された古い要素）は読み飛ばす
+		if (m_closedGen[current.index] == m_generation) continue;
+		m_closedGen[current.index] = m_generation;
+
+		const Point currentPoint = toPoint(current.index);
+		trace.recordClosed(currentPoint);
+
+		if (current.index == goalIndex) return true;
+
+		// 周囲8マスの地形は1回で調べ、壁の方向は展開しない
+		const uint8 terrainMask = terrainNeighborMask(mapData, currentPoint);
+		for (size_t i = 0; i < std::size(Directions); ++i) {
+			if (!((terrainMask >> i) & 1)) continue;
+
+			const Point neighbor = currentPoint + Directions[i];
+			if (!m_bounds.contains(neighbor) || m_occupancy->isOccupied(neighbor)) continue;
+
+			// 移動コストは1
+			if (relax(toIndex(neighbor), current.index, current.g + 1, goal)) {
+				trace.recordOpen(neighbor);
+			}
+		}
+	}
+
+	// ゴールに到達できなかった場合
+	return false;
+}
+
+int32 PathFinder::jump(Point from, Point dir, Point goal, const TileGrid& mapData) const {
+	Point p = from;
+	while (true) {
+		p += dir;
+		if (!IsWalkable(mapData, p)) return -1;
+		if (p == goal) return toIndex(p);
+
+		if (dir.x != 0 && dir.y != 0) {
+			// 斜め移動：強制隣接マスがあるか、縦横の跳躍で跳躍点が見つかればここで止まる
+			if ((IsWalkable(mapData, { p.x - dir.x, p.y + dir.y }) && !IsWalkable(mapData, { p.x - dir.x, p.y })) ||
+				(IsWalkable(mapData, { p.x + dir.x, p.y - dir.y }) && !IsWalkable(mapData, { p.x, p.y - dir.y }))) {
+				return toIndex(p);
+			}
+			if (jump(p, { dir.x, 0 }, goal, mapData) != -1 || jump(p, { 0, dir.y }, goal, mapData) != -1) {
+				return toIndex(p);
+			}
+		}
+		else if (dir.x != 0) {
+			// 横移動：上下の壁が途切れた所に強制隣接マスができる
+			if ((IsWalkable(mapData, { p.x + dir.x, p.y + 1 }) && !IsWalkable(mapData, { p.x, p.y + 1 })) ||
+				(IsWalkable(mapData, { p.x + dir.x, p.y - 1 }) && !IsWalkable(mapData, { p.x, p.y - 1 }))) {
+				return toIndex(p);
+			}
+		}
+		else {
+			// 縦移動：左右の壁が途切れた所に強制隣接マスができる
+			if ((IsWalkable(mapData, { p.x + 1, p.y + dir.y }) && !IsWalkable(mapData, { p.x + 1, p.y })) ||
+				(IsWalkable(mapData, { p.x - 1, p.y + dir.y }) && !IsWalkable(mapData, { p.x - 1, p.y }))) {
+				return toIndex(p);
+			}
+		}
+	}
+}
+
+template <class Trace>
+bool PathFinder::searchJumpPoint(Point, Point goal, const TileGrid& mapData, Trace& trace) {
+	const int32 goalIndex = toIndex(goal);
+
+	while (!m_heap.isEmpty()) {
+		const HeapNode current = heapPop();
+
+		if (m_closedGen[current.index] == m_generation) continue;
+		m_closedGen[current.index] = m_generation;
+
+		const Point p = toPoint(current.index);
+		trace.recordClosed(p);
+
+		if (current.index == goalIndex) return true;
+
+		// 親からの進行方向で、調べる方向を絞り込む（始点は8方向すべて）
+		if (m_parent[current.index] == -1) {
+			for (const auto& dir : Directions) {
+				if (IsWalkable(mapData, p + dir)) {
+					const int32 next = jump(p, dir, goal, mapData);
+					if (next != -1 && relax(next, current.index, current.g + Heuristic(p, toPoint(next)), goal)) {
+						trace.recordOpen(toPoint(next));
+					}
+				}
+			}
+			continue;
+		}
+
+		const Point parent = toPoint(m_parent[current.index]);
+		const int32 dx = (p.x > parent.x) - (p.x < parent.x);
+		const int32 dy = (p.y > parent.y) - (p.y < parent.y);
+
+		// 自然な隣接方向と、壁の角でできる強制隣接方向
+		Point candidates[5];
+		size_t candidateCount = 0;
+
+		if (dx != 0 && dy != 0) {
+			candidates[candidateCount++] = { 0, dy };
+			candidates[candidateCount++] = { dx, 0 };
+			candidates[candidateCount++] = { dx, dy };
+			if (!IsWalkable(mapData, { p.x - dx, p.y })) candidates[candidateCount++] = { -dx, dy };
+			if (!IsWalkable(mapData, { p.x, p.y - dy })) candidates[candidateCount++] = { dx, -dy };
+		}
+		else if (dx != 0) {
+			candidates[candidateCount++] = { dx, 0 };
+			if (!IsWalkable(mapData, { p.x, p.y + 1 })) candidates[candidateCount++] = { dx, 1 };
+			if (!IsWalkable(mapData, { p.x, p.y - 1 })) candidates[candidateCount++] = { dx, -1 };
+		}
+		else {
+			candidates[candidateCount++] = { 0, dy };
+			if (!IsWalkable(mapData, { p.x + 1, p.y })) candidates[candidateCount++] = { 1, dy };
+			if (!IsWalkable(mapData, { p.x - 1, p.y })) candidates[candidateCount++] = { -1, dy };
+		}
+
+		for (size_t i = 0; i < candidateCount; ++i) {
+			const int32 next = jump(p, candidates[i], goal, mapData);
+			if (next == -1) continue;
+
+			// 跳躍点までは直線か斜めの一直線なので、コストはチェビシェフ距離そのもの
+			if (relax(next, current.index, current.g + Heuristic(p, toPoint(next)), goal)) {
+				trace.recordOpen(toPoint(next));
+			}
+		}
+	}
+
+	return false;
+}
+
+template bool PathFinder::findPath<NullSearchTrace>(Point, Point, const TileGrid&, const OccupancyGrid&, Array<Point>&, NullSearchTrace&);
+# if DW_SEARCH_TRACE
+template bool PathFinder::findPath<EnemySearchTrace>(Point, Point, const TileGrid&, const OccupancyGrid&, Array<Point>&, EnemySearchTrace&);
+# endif
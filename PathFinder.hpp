@@ -0,0 +1,126 @@
+﻿#pragma once
+# include "Common.hpp"
+# include "SearchTrace.hpp"
+# include "RoomGraph.hpp"
+# include "OccupancyGrid.hpp"
+# include "WalkableBitboard.hpp"
+# include "Tile.hpp"
+
+// 経路探索の方式
+enum class PathSearchMode {
+	AStar,      // 8近傍を全て展開する A*
+	JumpPoint,  // Jump Point Search（一様コストの格子で対称な経路を飛ばす）
+	Hierarchical, // 部屋と通路のグラフで大まかに計画し、次の中継点までだけをJPSで探索する
+};
+
+// 敵の経路探索エンジン
+// マップと同じ大きさの作業配列を使い回し、世代番号で毎回の初期化を省く。
+// 一度マップサイズに合わせて確保すれば、以降の探索ではヒープ確保を行わない。
+class PathFinder {
+public:
+	// マップサイズに合わせて作業領域を確保する（サイズが変わった時だけ再確保）
+	void reserve(Size mapSize);
+
+	// 探索方式を切り替える（AStar と JumpPoint は同じ長さの最短経路を返す）
+	void setMode(PathSearchMode mode) { m_mode = mode; }
+	PathSearchMode getMode() const { return m_mode; }
+
+	// 階層モードで使う部屋グラフ（MapGenerator::generatedRoomGraph）を設定する
+	void setRoomGraph(const RoomGraph* graph) { m_roomGraph = graph; }
+
+	// 地形の通れるマスの表（FloorPlan::walkable）を設定する（nullptr なら mapData のマス番号を見る）
+	void setWalkable(const WalkableBitboard* walkable) { m_walkable = walkable; }
+
+	// start から goal への最短経路を探索し、route に1マスずつ書き込む（route[0] == start）
+	// 地形 mapData の壁と、occupancy で誰かがいるマスは通れない
+	// 階層モードでは route は次の中継点（通路の出入口）までの区間になる
+	// goal が壁か誰かのいるマスなら、探索せずに false を返す（階層モードでは部屋グラフで繋がらない場合も）
+	// trace には探索の様子が記録される（NullSearchTrace なら何もしない）
+	template <class Trace>
+	bool findPath(Point start, Point goal, const TileGrid& mapData, const OccupancyGrid& occupancy, Array<Point>& route, Trace& trace);
+
+	bool findPath(Point start, Point goal, const TileGrid& mapData, const OccupancyGrid& occupancy, Array<Point>& route) {
+		NullSearchTrace trace;
+		return findPath(start, goal, mapData, occupancy, route, trace);
+	}
+
+	// 8方向・移動コスト1なのでチェビシェフ距離が許容的なヒューリスティックになる
+	static int32 Heuristic(Point a, Point b) { return Max(Abs(a.x - b.x), Abs(a.y - b.y)); }
+
+private:
+	// オープンリストの要素
+	struct HeapNode {
+		int32 f;      // 総コスト
+		int32 g;      // 開始点からのコスト（同じ f なら g が大きい方を優先する）
+		int32 index;  // マスの通し番号 (y * width + x)
+	};
+
+	template <class Trace>
+	bool searchAStar(Point start, Point goal, const TileGrid& mapData, Trace& trace);
+
+	template <class Trace>
+	bool searchJumpPoint(Point start, Point goal, const TileGrid& mapData, Trace& trace);
+
+	// from から (dx, dy) 方向に跳び、次の跳躍点を返す（無ければ -1）
+	int32 jump(Point from, Point dir, Point goal, const TileGrid& mapData) const;
+
+	// ゴールから親を辿って route を作る（跳躍点の間は1マスずつ埋める）
+	void buildRoute(int32 goalIndex, Array<Point>& route) const;
+
+	// 部屋グラフ上で start から goal への大まかな経路を求め、最初の中継点を返す
+	// （start か goal が部屋・通路の外にある場合や、グラフで繋がらない場合は none）
+	Optional<Point> planNextWaypoint(Point start, Point goal);
+
+	// 始点の登録など、両方式に共通する探索の準備
+	void pushStart(Point start, Point goal);
+	// 未確定のマスを g で登録し直す（より良いコストの時だけ）
+	bool relax(int32 index, int32 parentIndex, int32 g, Point goal);
+
+	void heapPush(const HeapNode& node);
+	HeapNode heapPop();
+	static bool HeapLess(const HeapNode& a, const HeapNode& b);
+
+	// 新しい探索を始める（世代番号を進めるだけで作業配列は消さない）
+	void beginSearch();
+
+	int32 toIndex(Point p) const { return p.y * m_width + p.x; }
+	Point toPoint(int32 index) const { return Point{ index % m_width, index / m_width }; }
+
+	// 探索範囲内の通行可能で、誰もいないマスか
+	bool IsWalkable(const TileGrid& mapData, Point p) const {
+		return m_bounds.contains(p) && (m_walkable ? m_walkable->isWalkable(p) : IsPassable(mapData[p])) && !m_occupancy->isOccupied(p);
+	}
+
+	// p の周囲8マスのうち地形が通れるマス（ビット i が WalkableBitboard::Directions[i]）
+	uint8 terrainNeighborMask(const TileGrid& mapData, Point p) const;
+
+	PathSearchMode m_mode = PathSearchMode::AStar;
+	const RoomGraph* m_roomGraph = nullptr;
+	const WalkableBitboard* m_walkable = nullptr;
+	// 探索中だけ参照する、キャラクターのいるマス
+	const OccupancyGrid* m_occupancy = nullptr;
+
+	// 今回の探索で踏み込んでよい範囲（通常はマップ全体）
+	Rect m_bounds{ 0, 0, 0, 0 };
+	// 中継点までの局所探索で、始点と中継点を囲む矩形から広げる幅
+	static constexpr int32 LocalSearchMargin = 2;
+
+	int32 m_width = 0;
+	int32 m_height = 0;
+
+	uint32 m_generation = 0;      // 現在の探索の世代番号
+	Array<uint32> m_openedGen;    // マスが今回の探索で評価済みなら m_generation
+	Array<uint32> m_closedGen;    // マスが今回の探索で確定済みなら m_generation
+	Array<int32> m_gScore;        // 開始点からのコスト
+	Array<int32> m_parent;        // 親マスの通し番号
+
+	Array<HeapNode> m_heap;       // 二分ヒープ（容量は使い回す）
+
+	// 部屋グラフ上の探索用（ノードは通路の両端の出入口、末尾2つが始点と終点）
+	uint32 m_nodeGeneration = 0;
+	Array<uint32> m_nodeGen;
+	Array<int32> m_nodeCost;
+	Array<int32> m_nodeParent;
+	Array<HeapNode> m_nodeHeap;
+	Array<int32> m_nodePath;
+};
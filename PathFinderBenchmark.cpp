@@ -0,0 +1,76 @@
+﻿
+#include "PathFinderBenchmark.hpp"
+#include "MapGenerator.hpp"
+#include "PathFinder.hpp"
+
+namespace {
+	constexpr uint64 BenchmarkSeed = 20240601;
+}
+
+PathFinderBenchmarkResult RunPathFinderBenchmark(int32 mapCount, int32 queriesPerMap) {
+	PathFinderBenchmarkResult result;
+
+	// 毎回同じマップと始点・終点で測れるよう、シードを固定する
+	MapGenerator generator;
+	DefaultRNG queryRng{ BenchmarkSeed };
+	PathFinder aStar;
+	PathFinder jumpPoint;
+	jumpPoint.setMode(PathSearchMode::JumpPoint);
+
+	OccupancyGrid occupancy;  // キャラクターのいない空のマップで測る
+	Array<Point> floorTiles;
+	Array<std::pair<Point, Point>> queries;
+	Array<Point> route;
+	Array<int32> aStarLengths;
+
+	for (int32 m = 0; m < mapCount; ++m) {
+		generator.setSeed(MapGenerator::FloorSeed(BenchmarkSeed, m));
+		const TileGrid mapData = generator.generateFullMap(generator.generateMiniMap());
+
+		occupancy.reset(mapData.size());
+		floorTiles.clear();
+		for (int32 y = 0; y < static_cast<int32>(mapData.height()); ++y) {
+			for (int32 x = 0; x < static_cast<int32>(mapData.width()); ++x) {
+				if (IsPassable(mapData[y][x])) {
+					floorTiles << Point{ x, y };
+				}
+			}
+		}
+		if (floorTiles.size() < 2) continue;
+
+		// 両方式に同じ始点・終点の組を与える
+		queries.clear();
+		for (int32 q = 0; q < queriesPerMap; ++q) {
+			const int32 last = static_cast<int32>(floorTiles.size()) - 1;
+			queries.emplace_back(floorTiles[Random(0, last, queryRng)], floorTiles[Random(0, last, queryRng)]);
+		}
+
+		aStarLengths.clear();
+		{
+			const Stopwatch stopwatch{ StartImmediately::Yes };
+			for (const auto& [start, goal] : queries) {
+				aStarLengths << (aStar.findPath(start, goal, mapData, occupancy, route) ? static_cast<int32>(route.size()) : -1);
+			}
+			result.aStarMillisec += stopwatch.msF();
+		}
+
+		{
+			const Stopwatch stopwatch{ StartImmediately::Yes };
+			for (size_t q = 0; q < queries.size(); ++q) {
+				const int32 length = (jumpPoint.findPath(queries[q].first, queries[q].second, mapData, occupancy, route) ? static_cast<int32>(route.size()) : -1);
+				if (length != aStarLengths[q]) {
+					++result.lengthMismatches;
+				}
+				if (length != -1) {
+					++result.foundCount;
+				}
+			}
+			result.jumpPointMillisec += stopwatch.msF();
+		}
+
+		++result.mapCount;
+		result.queryCount += static_cast<int32>(queries.size());
+	}
+
+	return result;
+}
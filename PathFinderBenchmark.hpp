@@ -0,0 +1,15 @@
+﻿#pragma once
+# include "Common.hpp"
+
+// A* と Jump Point Search の比較ベンチマークの結果
+struct PathFinderBenchmarkResult {
+	int32 mapCount = 0;          // 生成したマップ数
+	int32 queryCount = 0;        // 1方式あたりの探索回数
+	int32 foundCount = 0;        // 経路が見つかった回数
+	double aStarMillisec = 0.0;      // A* の合計時間
+	double jumpPointMillisec = 0.0;  // JPS の合計時間
+	int32 lengthMismatches = 0;  // 経路長が一致しなかった回数（0 でなければ不具合）
+};
+
+// MapGenerator で作ったマップ上のランダムな床同士で両方式を走らせ、時間と経路長を比べる
+PathFinderBenchmarkResult RunPathFinderBenchmark(int32 mapCount, int32 queriesPerMap);
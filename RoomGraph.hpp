@@ -0,0 +1,55 @@
+﻿#pragma once
+# include "Common.hpp"
+
+// MapGenerator が出力する部屋と通路の抽象グラフ（階層的な経路探索で使う）
+struct RoomGraph {
+	// 通路：部屋 roomA 内の doorA と、部屋 roomB 内の doorB を結ぶ
+	struct Corridor {
+		int32 roomA;
+		int32 roomB;
+		Point doorA;
+		Point doorB;
+		int32 cost;  // 通路を通り抜ける歩数（L字に掘るので縦横の差の和を上限とする）
+	};
+
+	Array<Rect> rooms;                   // 部屋の矩形（generatedRoomAreas と同じ順番）
+	Array<Corridor> corridors;           // 掘られた通路
+	Array<Array<int32>> roomCorridors;   // 部屋ごとの、その部屋に繋がる通路番号
+	Grid<int32> roomOfTile;              // マスが属する部屋番号（-1: 部屋の外）
+	Grid<int32> corridorOfTile;          // マスを最後に掘った通路番号（-1: 通路ではない）
+
+	void reset(Size mapSize) {
+		rooms.clear();
+		corridors.clear();
+		roomCorridors.clear();
+		roomOfTile.assign(mapSize.x, mapSize.y, -1);
+		corridorOfTile.assign(mapSize.x, mapSize.y, -1);
+	}
+
+	bool isEmpty() const { return rooms.isEmpty(); }
+
+	int32 roomAt(Point p) const { return roomOfTile.inBounds(p) ? roomOfTile[p] : -1; }
+	int32 corridorAt(Point p) const { return corridorOfTile.inBounds(p) ? corridorOfTile[p] : -1; }
+
+	// 部屋を登録する（番号を返す）
+	int32 addRoom(const Rect& area) {
+		const int32 id = static_cast<int32>(rooms.size());
+		rooms << area;
+		roomCorridors.emplace_back();
+		for (int32 y = area.y; y < area.y + area.h; ++y) {
+			for (int32 x = area.x; x < area.x + area.w; ++x) {
+				if (roomOfTile.inBounds(Point{ x, y })) roomOfTile[y][x] = id;
+			}
+		}
+		return id;
+	}
+
+	// 通路を登録する（番号を返す）。マスへの書き込みは通路を掘る側が行う
+	int32 addCorridor(int32 roomA, Point doorA, int32 roomB, Point doorB) {
+		const int32 id = static_cast<int32>(corridors.size());
+		corridors << Corridor{ roomA, roomB, doorA, doorB, Abs(doorA.x - doorB.x) + Abs(doorA.y - doorB.y) };
+		if (roomA >= 0) roomCorridors[roomA] << id;
+		if (roomB >= 0) roomCorridors[roomB] << id;
+		return id;
+	}
+};
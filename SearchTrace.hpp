@@ -0,0 +1,76 @@
+﻿#pragma once
+# include "Common.hpp"
+
+// 経路探索の様子（オープン/クローズしたマス）を記録するポリシー
+// DW_SEARCH_TRACE が 0 のビルドでは NullSearchTrace が選ばれ、記録も描画も消える
+# ifndef DW_SEARCH_TRACE
+#	ifdef _DEBUG
+#		define DW_SEARCH_TRACE 1
+#	else
+#		define DW_SEARCH_TRACE 0
+#	endif
+# endif
+
+// 何も記録しないポリシー（リリース用）
+struct NullSearchTrace {
+	static constexpr bool Enabled = false;
+
+	void clear() {}
+	void recordOpen(Point) {}
+	void recordClosed(Point) {}
+
+	template <class Fn> void eachOpen(Fn&&) const {}
+	template <class Fn> void eachClosed(Fn&&) const {}
+};
+
+// 直近 Capacity 件だけを保持する固定長リングバッファ
+template <size_t Capacity>
+class PointRingBuffer {
+public:
+	void clear() { m_head = 0; m_size = 0; }
+
+	void push(Point p) {
+		m_items[(m_head + m_size) % Capacity] = p;
+		if (m_size < Capacity) {
+			++m_size;
+		}
+		else {
+			m_head = (m_head + 1) % Capacity; // 一番古いものを上書き
+		}
+	}
+
+	template <class Fn>
+	void each(Fn&& fn) const {
+		for (size_t i = 0; i < m_size; ++i) {
+			fn(m_items[(m_head + i) % Capacity]);
+		}
+	}
+
+private:
+	std::array<Point, Capacity> m_items;
+	size_t m_head = 0;
+	size_t m_size = 0;
+};
+
+// 上限付きで記録するポリシー（デバッグ用）
+template <size_t Capacity>
+struct RingSearchTrace {
+	static constexpr bool Enabled = true;
+
+	void clear() { open.clear(); closed.clear(); }
+	void recordOpen(Point p) { open.push(p); }
+	void recordClosed(Point p) { closed.push(p); }
+
+	template <class Fn> void eachOpen(Fn&& fn) const { open.each(std::forward<Fn>(fn)); }
+	template <class Fn> void eachClosed(Fn&& fn) const { closed.each(std::forward<Fn>(fn)); }
+
+	PointRingBuffer<Capacity> open;
+	PointRingBuffer<Capacity> closed;
+};
+
+// 敵が使う記録ポリシー
+# if DW_SEARCH_TRACE
+using EnemySearchTrace = RingSearchTrace<256>;
+# else
+using EnemySearchTrace = NullSearchTrace;
+# endif
@@ -0,0 +1,125 @@
+﻿
+#include "Simulation.hpp"
+
+void Simulation::load(FloorPlan plan) {
+	m_floor = std::move(plan);
+	m_occupancy.reset(m_floor.tiles.size());
+
+	// 通れるマスの表・視界表のない階（生成に失敗したときの代わりの階など）はここで作る
+	if (m_floor.walkable.size() != m_floor.tiles.size()) {
+		m_floor.walkable.build(m_floor.tiles);
+	}
+	if (!m_floor.visibility.isBuiltFor(m_floor.tiles.size())) {
+		m_floor.visibility.build(m_floor.tiles);
+	}
+
+	// 経路探索の作業領域は階を読み込むときにまとめて確保しておく
+	m_pathFinder.reserve(m_floor.tiles.size());
+	m_pathFinder.setRoomGraph(&m_floor.roomGraph);
+	m_pathFinder.setWalkable(&m_floor.walkable);
+	m_pathFinder.setMode((m_floor.tiles.width() > HierarchicalPathMinMapSize) ? PathSearchMode::Hierarchical : EnemyPathSearchMode);
+
+	// プレイヤーの位置を設定する
+	m_player.SetPlayerPos(m_floor.start.value_or(Point{ 0, 0 }));
+	m_occupancy.setPlayer(m_player.GetPlayerPos());
+	m_playerView.reset(m_floor.tiles.size());
+	m_playerView.update(m_player.GetPlayerPos(), m_floor.tiles);
+
+	// 敵をスポーンする
+	m_enemies.clear();
+	m_enemies.reserve(m_floor.enemySpawns.size());
+	m_sleeping.clear();
+	m_sleeping.reserve(m_floor.enemySpawns.size());
+	m_sleepingHead = 0;
+	m_sleepingActions = 0;
+	for (const auto& spawnPos : m_floor.enemySpawns) {
+		m_enemies.spawn(spawnPos, 0, m_occupancy); // 新しい敵（タイプ0）を追加し、マスに番号を登録する
+	}
+
+	m_turnCount = 0;
+}
+
+TurnResult Simulation::step(const TurnAction& action) {
+	TurnResult result;
+	++m_turnCount;
+
+	// 前のターンに後回しにした敵がまだ残っていれば、プレイヤーが動く前に全て行動させる
+	// （行動を飛ばすとフレームの時間で結果が変わる。敵の番号は倒れた敵の片付けで変わるので、その前に列を空にする）
+	updateSleepingEnemies();
+	m_sleeping.clear();
+	m_sleepingHead = 0;
+
+	//プレイヤー移動（敵のいるマスへは動かず、そのマスが返る）
+	const Point enemyHitPos = m_player.Move(action.direction.x, action.direction.y, m_floor.tiles, m_occupancy);
+
+	// 視界は動いたときだけ求め直す（動かなければ前のターンのまま）
+	m_playerView.update(m_player.GetPlayerPos(), m_floor.tiles);
+
+	//プレイヤーがマップを進めるマスにいるか (Goal tile is 4)
+	if (m_floor.tiles[m_player.GetPlayerPos()] == Tile::Goal) {
+		result.reachedGoal = true;
+		return result;
+	}
+
+	//ダメージ
+	if (enemyHitPos != Point{ -1,-1 }) {
+		result.bumpedEnemy = enemyHitPos;
+
+		// 攻撃先の敵はマスから直接引く（敵の一覧を走査しない）
+		if (action.attackIntent) {
+			if (const auto hitEnemy = m_occupancy.enemyAt(enemyHitPos)) {
+				m_enemies.damage(*hitEnemy, m_player.Attack());
+				result.attacked = true;
+			}
+		}
+	}
+
+	//敵の生存確認 & remove dead enemies
+	// 最後の敵と入れ替えて取り除くので、配列の途中を詰め直さない
+	const size_t enemyCount = m_enemies.size();
+	m_enemies.removeDead(m_occupancy);
+	result.enemiesDefeated = static_cast<int32>(enemyCount - m_enemies.size());
+
+	//プレイヤーまでの距離マップを1回だけ作り直し、全ての敵で共有する
+	m_playerField.build(m_player.GetPlayerPos(), m_floor.walkable, PlayerFieldRange);
+
+	//エネミー移動と攻撃
+	// プレイヤーの近くの敵は番号順にこの場で行動させ、遠くの敵は後回しの列に積む
+	const Point playerPos = m_player.GetPlayerPos();
+	for (size_t i = 0; i < m_enemies.size(); ++i) {
+		const Point enemyPos = m_enemies.position(i);
+		if (Max(Abs(enemyPos.x - playerPos.x), Abs(enemyPos.y - playerPos.y)) > EnemyAwakeRange) {
+			m_sleeping << i;
+			continue;
+		}
+
+		const int32 damage = m_enemies.act(i, playerPos, m_floor.tiles, m_floor.visibility, m_occupancy, m_playerField, m_pathFinder);
+		m_player.Damage(damage);
+		result.damageTaken += damage;
+	}
+
+	// 後回しにしてもしなくても、眠っている敵は近くの敵の後に番号順で行動する（結果は同じになる）
+	if (!m_deferSleeping) {
+		updateSleepingEnemies();
+	}
+
+	return result;
+}
+
+size_t Simulation::updateSleepingEnemies(const Optional<Duration>& budget) {
+	const Stopwatch stopwatch{ StartImmediately::Yes };
+	const Point playerPos = m_player.GetPlayerPos();
+
+	size_t processed = 0;
+	while (m_sleepingHead < m_sleeping.size()) {
+		// 予算が小さすぎても、1回の呼び出しで少なくとも1体は進める
+		if (budget && (processed > 0) && (stopwatch.elapsed() >= *budget)) break;
+
+		const size_t index = m_sleeping[m_sleepingHead++];
+		// 眠っている敵はプレイヤーに届かないので、ダメージは生じない
+		m_player.Damage(m_enemies.act(index, playerPos, m_floor.tiles, m_floor.visibility, m_occupancy, m_playerField, m_pathFinder));
+		++processed;
+	}
+	m_sleepingActions += processed;
+	return processed;
+}
@@ -0,0 +1,93 @@
+﻿#pragma once
+# include "Common.hpp"
+# include "FloorPlan.hpp"
+# include "OccupancyGrid.hpp"
+# include "EnemyStore.hpp"
+# include "FlowField.hpp"
+# include "PathFinder.hpp"
+# include "BasePlayer.hpp"
+# include "FieldOfView.hpp"
+
+// 1ターンぶんの入力
+struct TurnAction {
+	Point direction{ 0, 0 };    // 移動方向（{0,0} は足踏み）
+	bool attackIntent = true;   // 敵のいるマスへ動こうとしたときに攻撃するか（押しっぱなしの連続移動では攻撃しない）
+};
+
+// 1ターンの結果（演出は呼び出し側がこれを見て行う）
+struct TurnResult {
+	Optional<Point> bumpedEnemy;   // 移動先にいた敵のマス（プレイヤーは動かない）
+	bool attacked = false;         // その敵を攻撃した
+	int32 enemiesDefeated = 0;     // このターンに倒した敵の数
+	int32 damageTaken = 0;         // 敵から受けたダメージ
+	bool reachedGoal = false;      // ゴールに着いた（このターンの敵の行動は行わない）
+};
+
+// ターン制のルール（プレイヤーの移動と攻撃、敵の行動）
+// シーン・タイマー・描画に依存しないので、ウィンドウなしで何ターンでも回せる。
+// Game はこれに入力を渡し、返ってきた結果で演出をつけて描くだけにする。
+class Simulation {
+public:
+	// 距離マップを広げる最大歩数（追跡は索敵範囲内でしか起きない）
+	static constexpr int32 PlayerFieldRange = 16;
+	// 敵の経路探索方式（JPS は A* と同じ長さの経路をより少ない展開で求める）
+	static constexpr PathSearchMode EnemyPathSearchMode = PathSearchMode::JumpPoint;
+	// これより大きいマップでは部屋グラフを使った階層的な経路探索に切り替える
+	static constexpr int32 HierarchicalPathMinMapSize = 50;
+	// プレイヤーからこれより遠い（チェビシェフ距離）敵は眠っている扱いにし、ターンの処理では後回しにする
+	// 索敵範囲より十分遠いので、眠っている敵がそのターンにプレイヤーを見つけたり攻撃したりすることはない
+	static constexpr int32 EnemyAwakeRange = PlayerFieldRange;
+	static_assert(EnemyAwakeRange > VisibilityCache::SightRange + 1);
+
+	// 階を読み込み、プレイヤーをスタート地点に、敵を出現位置に置く
+	// 同じ大きさの階なら、占有情報・敵の配列・探索の作業領域は確保済みのものを使い回す
+	void load(FloorPlan plan);
+
+	// 1ターン進める（プレイヤーの近くの敵は必ずこの中で行動する）
+	TurnResult step(const TurnAction& action);
+
+	// 眠っている敵の行動を step の中で行わず、updateSleepingEnemies に任せる（既定では step の中で全て行う）
+	// 敵の数が多くても、step（入力に対する処理）の時間はプレイヤーの近くの敵の数で決まるようになる
+	void setDeferSleepingEnemies(bool defer) { m_deferSleeping = defer; }
+
+	// 後回しにした眠っている敵を番号順に行動させ、行動させた数を返す
+	// budget を使い切ったら残りは次の呼び出しに回す（none なら全て行動させる）。
+	// 次の step までに行動できなかった敵は、その step の最初（プレイヤーが動く前）に全て行動させる。
+	// そのため、後回しにするかどうかやフレームの時間によって、同じ入力からの結果は変わらない
+	size_t updateSleepingEnemies(const Optional<Duration>& budget = none);
+
+	// このターンにまだ行動していない眠っている敵の数
+	size_t pendingSleepingEnemies() const { return m_sleeping.size() - m_sleepingHead; }
+
+	// load してから眠っている敵が行動した延べ数（後回しにしてもしなくても同じになる）
+	int64 sleepingEnemyActions() const { return m_sleepingActions; }
+
+	const FloorPlan& floor() const { return m_floor; }
+	// 地形（階の途中では書き換えない）
+	const TileGrid& tiles() const { return m_floor.tiles; }
+	const OccupancyGrid& occupancy() const { return m_occupancy; }
+	const EnemyStore& enemies() const { return m_enemies; }
+	// プレイヤーの視界と探索済みのマス（プレイヤーが動いたターンだけ更新される）
+	const FieldOfView& playerView() const { return m_playerView; }
+
+	BasePlayer& player() { return m_player; }
+	const BasePlayer& player() const { return m_player; }
+
+	// load してから進めたターン数
+	int64 turnCount() const { return m_turnCount; }
+
+private:
+	FloorPlan m_floor;          // 現在の階（部屋グラフは経路探索から参照される）
+	OccupancyGrid m_occupancy;  // プレイヤーと敵がいるマス
+	EnemyStore m_enemies;       // 敵は項目ごとの配列にまとめて持つ
+	FlowField m_playerField;    // プレイヤーまでの距離マップ（全ての敵の追跡で共有）
+	PathFinder m_pathFinder;    // 巡回・退避で使う経路探索エンジン（作業領域を全ての敵で使い回す）
+	BasePlayer m_player;
+	FieldOfView m_playerView;   // プレイヤーの視界（霧）
+	int64 m_turnCount = 0;
+
+	bool m_deferSleeping = false;
+	Array<size_t> m_sleeping;   // このターンに後回しにした敵の番号（番号順）
+	size_t m_sleepingHead = 0;  // m_sleeping のうち次に行動させる位置
+	int64 m_sleepingActions = 0;
+};
@@ -0,0 +1,151 @@
+﻿
+#include "TerrainRenderer.hpp"
+
+namespace {
+	// 透過した RenderTexture に描き込むときのブレンド（描いた部分のアルファを残す）
+	BlendState MakeChunkBlendState() {
+		BlendState blendState = BlendState::Default2D;
+		blendState.srcAlpha = Blend::SrcAlpha;
+		blendState.dstAlpha = Blend::DestAlpha;
+		blendState.opAlpha = BlendOp::Max;
+		return blendState;
+	}
+}
+
+void TerrainRenderer::reset(const TileGrid* tiles, const FieldOfView* view, int32 pieceSize, int32 wallThickness, const ColorF& floorColor) {
+	const Size chunkCount = (tiles && !tiles->isEmpty())
+		? Size{ (static_cast<int32>(tiles->width()) + ChunkTiles - 1) / ChunkTiles, (static_cast<int32>(tiles->height()) + ChunkTiles - 1) / ChunkTiles }
+		: Size{ 0, 0 };
+	const bool sameLayout = (m_chunks.size() == chunkCount) && (m_pieceSize == pieceSize) && (m_wallThickness == wallThickness);
+
+	m_tiles = tiles;
+	m_view = view;
+	m_pieceSize = pieceSize;
+	m_wallThickness = wallThickness;
+	m_floorColor = floorColor;
+	m_frame = 0;
+
+	// 同じ大きさの階なら、確保済みのテクスチャを焼き直して使い回す
+	if (sameLayout) {
+		for (auto& chunk : m_chunks) {
+			chunk.dirty = true;
+			chunk.lastUsed = 0;
+		}
+		return;
+	}
+
+	m_chunks.clear();
+	m_residentCount = 0;
+	m_chunks.resize(chunkCount.x, chunkCount.y);
+}
+
+void TerrainRenderer::invalidateTile(Point tile) {
+	const Point chunkPos{ tile.x / ChunkTiles, tile.y / ChunkTiles };
+	if (m_chunks.inBounds(chunkPos)) {
+		m_chunks[chunkPos].dirty = true;
+	}
+}
+
+Rect TerrainRenderer::visibleChunks(const Rect& visibleTiles) const {
+	if (m_chunks.isEmpty()) return Rect{ 0, 0, 0, 0 };
+
+	const int32 left = Clamp(visibleTiles.x / ChunkTiles, 0, static_cast<int32>(m_chunks.width()));
+	const int32 top = Clamp(visibleTiles.y / ChunkTiles, 0, static_cast<int32>(m_chunks.height()));
+	const int32 right = Clamp((visibleTiles.x + visibleTiles.w + ChunkTiles - 1) / ChunkTiles, left, static_cast<int32>(m_chunks.width()));
+	const int32 bottom = Clamp((visibleTiles.y + visibleTiles.h + ChunkTiles - 1) / ChunkTiles, top, static_cast<int32>(m_chunks.height()));
+	return Rect{ left, top, (right - left), (bottom - top) };
+}
+
+void TerrainRenderer::prepare(const Rect& visibleTiles) {
+	if (!m_tiles) return;
+
+	++m_frame;
+	const Rect visible = visibleChunks(visibleTiles);
+	for (int32 cy = visible.y; cy < visible.y + visible.h; ++cy) {
+		for (int32 cx = visible.x; cx < visible.x + visible.w; ++cx) {
+			Chunk& chunk = m_chunks[cy][cx];
+			if (!chunk.texture) {
+				chunk.texture = RenderTexture{ Size{ chunkPixels(), chunkPixels() } };
+				chunk.dirty = true;
+				++m_residentCount;
+			}
+			if (chunk.dirty) {
+				bake(Point{ cx, cy }, chunk);
+			}
+			chunk.lastUsed = m_frame;
+		}
+	}
+
+	if (m_residentCount > MaxResidentChunks) {
+		evict(visible);
+	}
+}
+
+// マスの配置は Game::getPaddle と同じ
+RectF TerrainRenderer::tileRect(Point tile) const {
+	return RectF{ (stride() * tile.x) + m_wallThickness, (stride() * tile.y) + m_wallThickness, static_cast<double>(m_pieceSize) };
+}
+
+// チャンク内のマスをテクスチャに描き込む（未探索のマスは描かない）
+void TerrainRenderer::bake(Point chunkPos, Chunk& chunk) const {
+	const ScopedRenderTarget2D target{ chunk.texture.clear(ColorF{ 0.0, 0.0 }) };
+	const ScopedRenderStates2D blend{ MakeChunkBlendState() };
+
+	const Point firstTile = chunkPos * ChunkTiles;
+	const int32 endX = Min(firstTile.x + ChunkTiles, static_cast<int32>(m_tiles->width()));
+	const int32 endY = Min(firstTile.y + ChunkTiles, static_cast<int32>(m_tiles->height()));
+	for (int32 y = firstTile.y; y < endY; ++y) {
+		for (int32 x = firstTile.x; x < endX; ++x) {
+			if (m_view && !m_view->isExplored(Point{ x, y })) continue;
+
+			if (const auto color = TileColor((*m_tiles)[y][x], m_floorColor)) {
+				tileRect(Point{ x, y } - firstTile).rounded(3).draw(*color);
+			}
+		}
+	}
+
+	chunk.dirty = false;
+}
+
+// 画面外のチャンクを、最後に使ったのが古いものから手放す
+void TerrainRenderer::evict(const Rect& keep) {
+	Array<Point> candidates;
+	for (int32 cy = 0; cy < static_cast<int32>(m_chunks.height()); ++cy) {
+		for (int32 cx = 0; cx < static_cast<int32>(m_chunks.width()); ++cx) {
+			const bool kept = InRange(cx, keep.x, keep.x + keep.w - 1) && InRange(cy, keep.y, keep.y + keep.h - 1);
+			if (m_chunks[cy][cx].texture && !kept) {
+				candidates << Point{ cx, cy };
+			}
+		}
+	}
+	candidates.sort_by([&](const Point& a, const Point& b) { return m_chunks[a].lastUsed < m_chunks[b].lastUsed; });
+
+	for (const auto& chunkPos : candidates) {
+		if (m_residentCount <= MaxResidentChunks) break;
+		m_chunks[chunkPos].texture = RenderTexture{};
+		--m_residentCount;
+	}
+}
+
+void TerrainRenderer::draw(const Vec2& camera, const Rect& visibleTiles) const {
+	// 霧があるときは、チャンクをまとめて暗く描いてから、今見えているマスだけを明るく描き直す
+	const ColorF chunkColor = m_view ? ColorF{ FogBrightness } : ColorF{ 1.0 };
+	const Rect visible = visibleChunks(visibleTiles);
+	for (int32 cy = visible.y; cy < visible.y + visible.h; ++cy) {
+		for (int32 cx = visible.x; cx < visible.x + visible.w; ++cx) {
+			const Chunk& chunk = m_chunks[cy][cx];
+			if (chunk.texture) {
+				chunk.texture.draw(Vec2{ cx * chunkPixels(), cy * chunkPixels() } - camera, chunkColor);
+			}
+		}
+	}
+
+	if (!m_view) return;
+	for (const auto& tile : m_view->visibleTiles()) {
+		if (!visibleTiles.contains(tile)) continue;
+
+		if (const auto color = TileColor((*m_tiles)[tile], m_floorColor)) {
+			tileRect(tile).movedBy(-camera).rounded(3).draw(*color);
+		}
+	}
+}
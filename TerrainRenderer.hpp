@@ -0,0 +1,56 @@
+﻿#pragma once
+# include "Common.hpp"
+# include "FieldOfView.hpp"
+# include "Tile.hpp"
+
+// 地形（床・スタート・ゴール）の描画
+// 地形はフロア中に変わらないので、ChunkTiles × ChunkTiles マスごとに RenderTexture へ焼き込んでおき、
+// 毎フレームは画面に入っているチャンクのテクスチャを数枚描くだけにする。
+// 焼き込むのは画面に入ったチャンクだけで、MaxResidentChunks を超えたら長く使っていないものから手放す。
+// 視界（FieldOfView）を渡したときは探索済みのマスだけを焼き込み、今見えていないマスは暗く描く。
+class TerrainRenderer {
+public:
+	static constexpr int32 ChunkTiles = 16;          // チャンクの一辺のマス数
+	static constexpr size_t MaxResidentChunks = 48;  // 同時に持つテクスチャの上限
+	static constexpr double FogBrightness = 0.45;    // 探索済みで今は見えていないマスの明るさ
+
+	// 描画する地形を設定する（tiles と view は描画中ずっと有効であること。view が nullptr なら霧なしで全て描く）
+	// マップとマスの大きさが前と同じならテクスチャは捨てずに、全て焼き直しの対象にする
+	void reset(const TileGrid* tiles, const FieldOfView* view, int32 pieceSize, int32 wallThickness, const ColorF& floorColor);
+
+	// マスを書き換えたとき・初めて探索したときに呼ぶ（そのマスを含むチャンクを次の prepare で焼き直す）
+	void invalidateTile(Point tile);
+
+	// 画面に入るマスの範囲（Camera::GetVisibleTiles）を含むチャンクを焼き込む（draw の前に1回呼ぶ）
+	void prepare(const Rect& visibleTiles);
+
+	// 画面に入るマスの範囲を含むチャンクを、camera を左上として描く
+	void draw(const Vec2& camera, const Rect& visibleTiles) const;
+
+private:
+	struct Chunk {
+		RenderTexture texture;
+		bool dirty = true;      // 焼き直しが必要
+		uint64 lastUsed = 0;    // 最後に画面に入ったフレーム
+	};
+
+	int32 stride() const { return m_pieceSize + m_wallThickness; }
+	int32 chunkPixels() const { return stride() * ChunkTiles; }
+
+	// マスの範囲を含むチャンクの範囲
+	Rect visibleChunks(const Rect& visibleTiles) const;
+
+	void bake(Point chunkPos, Chunk& chunk) const;
+	RectF tileRect(Point tile) const;  // チャンクの左上から見たマスの矩形
+	void evict(const Rect& keep);
+
+	const TileGrid* m_tiles = nullptr;
+	const FieldOfView* m_view = nullptr;
+	int32 m_pieceSize = 0;
+	int32 m_wallThickness = 0;
+	ColorF m_floorColor = Palette::White;
+
+	Grid<Chunk> m_chunks;
+	size_t m_residentCount = 0;  // テクスチャを持っているチャンクの数
+	uint64 m_frame = 0;
+};
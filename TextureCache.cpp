@@ -0,0 +1,104 @@
+﻿
+#include "TextureCache.hpp"
+
+namespace {
+	// 前処理の内容やファイル名の付け方を変えたら上げる（古いディスクキャッシュを使わないように）
+	constexpr int32 DiskCacheVersion = 2;
+
+	constexpr StringView CharaPaths[] = {
+		U"example/トゥマレ/トゥマレ_通常.png",
+		U"example/トゥマレ/トゥマレ_笑顔.png",
+		U"example/トゥマレ/トゥマレ_怒り.png",
+		U"example/トゥマレ/トゥマレ_呆れ.png",
+		U"example/トゥマレ/トゥマレ_苦笑い.png",
+		U"example/トゥマレ/トゥマレ_驚き.png",
+		U"example/トゥマレ/トゥマレ_口開き.png",
+		U"example/トゥマレ/トゥマレ_目閉じ.png",
+	};
+
+	struct CacheState {
+		HashTable<String, Texture> textures;
+		FilePath diskCacheDirectory;
+	};
+
+	CacheState& Cache() {
+		static CacheState state;
+		return state;
+	}
+
+	String MakeKey(FilePathView path, TexturePreprocess preprocess) {
+		return U"{}|{}"_fmt(path, FromEnum(preprocess));
+	}
+
+	// ディスクキャッシュのファイル名に使うハッシュ（64bit FNV-1a を UTF-8 のバイト列にかける）
+	// std::hash は実行ごとや処理系ごとに値が変わってよいので、保存するファイル名には使えない
+	uint64 StableHash(StringView key) {
+		uint64 hash = 14695981039346656037ull;
+		for (const char byte : Unicode::ToUTF8(key)) {
+			hash ^= static_cast<uint8>(byte);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+}
+
+const Texture& TextureCache::Get(FilePathView path, TexturePreprocess preprocess) {
+	auto& textures = Cache().textures;
+	const String key = MakeKey(path, preprocess);
+	if (auto it = textures.find(key); it != textures.end()) {
+		return it->second;
+	}
+	return textures.emplace(key, Texture{ Load(path, preprocess) }).first->second;
+}
+
+const Texture& TextureCache::Chara(CharaFace face) {
+	return Get(CharaPaths[FromEnum(face)], TexturePreprocess::ThresholdOtsu);
+}
+
+void TextureCache::SetDiskCacheDirectory(FilePathView directory) {
+	FilePath& cacheDirectory = Cache().diskCacheDirectory;
+	cacheDirectory = directory;
+	if (cacheDirectory.isEmpty()) return;
+
+	if (not cacheDirectory.ends_with(U'/')) {
+		cacheDirectory << U'/';
+	}
+	FileSystem::CreateDirectories(cacheDirectory);
+}
+
+void TextureCache::Clear() {
+	Cache().textures.clear();
+}
+
+Image TextureCache::Load(FilePathView path, TexturePreprocess preprocess) {
+	if (preprocess == TexturePreprocess::None) {
+		return Image{ Resource(path) };
+	}
+
+	// 前処理済みの画像がディスクにあればそれを使う
+	const FilePath& directory = Cache().diskCacheDirectory;
+	FilePath cachePath;
+	if (not directory.isEmpty()) {
+		const String key = U"{}|v{}"_fmt(MakeKey(path, preprocess), DiskCacheVersion);
+		cachePath = directory + U"{:016X}.png"_fmt(StableHash(key));
+		if (FileSystem::Exists(cachePath)) {
+			if (Image cached{ cachePath }) {
+				return cached;
+			}
+		}
+	}
+
+	Image image{ Resource(path) };
+	switch (preprocess) {
+	case TexturePreprocess::ThresholdOtsu:
+		image = image.thresholded_Otsu();
+		break;
+	default:
+		break;
+	}
+
+	if (not cachePath.isEmpty() && image) {
+		image.savePNG(cachePath);
+	}
+	return image;
+}
@@ -0,0 +1,41 @@
+﻿#pragma once
+# include "Common.hpp"
+
+// 読み込んだ画像にかける前処理
+enum class TexturePreprocess : uint8 {
+	None,
+	ThresholdOtsu,  // 大津の二値化（キャラクターの立ち絵）
+};
+
+// キャラクター（トゥマレ）の表情
+enum class CharaFace : uint8 {
+	Normal,      // 通常
+	Smile,       // 笑顔
+	Angry,       // 怒り
+	Amazed,      // 呆れ
+	WrySmile,    // 苦笑い
+	Surprised,   // 驚き
+	MouthOpen,   // 口開き
+	EyesClosed,  // 目閉じ
+};
+
+// プロセス全体で共有するテクスチャの置き場
+// （パス + 前処理）ごとに、初めて使われたときに1回だけ読み込む。シーンを作り直しても読み直さない。
+// ディスクキャッシュを有効にすると、前処理済みの画像を PNG で保存しておき、次回の起動からはそれを読む。
+// メインスレッドからのみ使うこと。
+class TextureCache {
+public:
+	static const Texture& Get(FilePathView path, TexturePreprocess preprocess = TexturePreprocess::None);
+
+	// キャラクターの立ち絵
+	static const Texture& Chara(CharaFace face);
+
+	// 前処理済み画像の保存先（空ならディスクキャッシュを使わない）
+	static void SetDiskCacheDirectory(FilePathView directory);
+
+	// 読み込み済みのテクスチャを全て手放す（Main を抜ける前に呼ぶ）
+	static void Clear();
+
+private:
+	static Image Load(FilePathView path, TexturePreprocess preprocess);
+};
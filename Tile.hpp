@@ -0,0 +1,46 @@
+﻿#pragma once
+# include "Common.hpp"
+
+// 地形のマスの種類（1バイト）
+// 値はマップの書き出し形式などで使っていた番号のまま。敵やプレイヤーは地形ではなく OccupancyGrid が持つ
+enum class Tile : uint8 {
+	Wall = 0,       // 壁
+	Floor = 1,      // 通路の床
+	Start = 2,      // スタート
+	Goal = 4,       // ゴール
+	DebugRoom = 5,  // 部屋の床（生成された部屋の範囲が分かるよう色を変えて描く）
+};
+
+// 地形のマップ（1マス1バイト）
+using TileGrid = Grid<Tile>;
+
+// マスの種類ごとの性質
+struct TileProperties {
+	bool passable;        // キャラクターが通れる
+	bool blocksSight;     // 視線を遮る
+	bool drawable;        // 描く（壁は背景のまま）
+	bool usesFloorColor;  // 階ごとの床の色で描く（false なら color で描く）
+	Color color;
+};
+
+// マスの番号で引く性質の表（3 は以前の敵の番号で、今は使わない）
+inline constexpr TileProperties TilePropertyTable[] = {
+	{ false, true, false, false, Palette::Black },     // 0: Wall
+	{ true, false, true, true, Palette::White },       // 1: Floor
+	{ true, false, true, false, Palette::Green },      // 2: Start
+	{ false, true, false, false, Palette::Black },     // 3: （未使用）
+	{ true, false, true, false, Palette::Yellow },     // 4: Goal
+	{ true, false, true, false, Palette::Magenta },    // 5: DebugRoom
+};
+
+constexpr const TileProperties& GetTileProperties(Tile tile) { return TilePropertyTable[static_cast<uint8>(tile)]; }
+
+constexpr bool IsPassable(Tile tile) { return GetTileProperties(tile).passable; }
+constexpr bool BlocksSight(Tile tile) { return GetTileProperties(tile).blocksSight; }
+
+// マスを描く色（描かないマスは none）
+inline Optional<ColorF> TileColor(Tile tile, const ColorF& floorColor) {
+	const TileProperties& properties = GetTileProperties(tile);
+	if (!properties.drawable) return none;
+	return properties.usesFloorColor ? floorColor : ColorF{ properties.color };
+}
@@ -1,4 +1,5 @@
 ﻿# include "Title.hpp"
+# include "TextureCache.hpp"
 
 Title::Title(const InitData& init)
 	: IScene{ init }
@@ -110,7 +111,7 @@ void Title::draw() const
 		.draw(TextStyle::OutlineShadow(0.2, ColorF{ 0.2 }, Vec2{ 3, 3 }, ColorF{ 0.5 }), 100, Vec2{ 25, 0 });
 
 	//キャラ描画
-	texture[0].resized(800).drawAt(500, 500);
+	TextureCache::Chara(CharaFace::Normal).resized(800).drawAt(500, 500);
 
 	if (IsLoad) {
 
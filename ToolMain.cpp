@@ -0,0 +1,280 @@
+﻿# include "Common.hpp"
+# include "MapGenBatch.hpp"
+# include "MapGenerator.hpp"
+# include "PathFinderBenchmark.hpp"
+# include "Simulation.hpp"
+# include "TurnBenchmark.hpp"
+# include <iostream>
+# if SIV3D_PLATFORM(WINDOWS)
+# include <Siv3D/Windows/Windows.hpp>
+# endif
+
+// ウィンドウを開かずに動かすツール（DungeonWalkingTool）
+//
+// 使い方：DungeonWalkingTool.exe [--count N] [--seed S] [--threads T] [--mini M] [--unit U] [--dump FILE]
+//   --count   生成するフロア数（既定 1000）
+//   --seed    最初のシード（既定 1。フロア i は S + i で生成）
+//   --threads スレッド数（既定 0 = コア数）
+//   --mini    ミニマップの一辺（既定 5、最小 2）
+//   --unit    部屋の一辺（既定 10、最小 5）
+//   --dump    生成したフロアを書き出すファイル
+//   --sim-turns T  生成の代わりに、各フロアでランダムに動くボットを T ターン動かす
+// 結果は標準出力に書く。生成に失敗したフロアがあるか、書き出しに失敗したら終了コード 1 で終わる
+//
+// ターン処理のベンチマーク：DungeonWalkingTool.exe --bench-turns [--turns N] [--defer-sleeping] [--baseline FILE] [--tolerance X] [--write-baseline FILE]
+//   --turns          1条件あたりの計測ターン数（既定 200）
+//   --defer-sleeping 遠くの敵を後回しにして（ゲームと同じ）、入力に対する処理の時間を測る
+//   --baseline       基準値の CSV。p99 か確保回数が悪化していたら終了コード 1 で終わる
+//                    ファイルが無ければ比べずに警告を出し、終了コード 2 で終わる（失敗ではなく「比べていない」）
+//   --tolerance      p99 の許容する悪化の割合（既定 0.25 = 25%）
+//   --write-baseline 今回の結果を基準値として書き出す
+//
+// 遠くの敵の後回しの確認：DungeonWalkingTool.exe --check-defer [--turns N]
+//   ベンチマークと同じ条件で、後回しにする場合としない場合の状態を毎ターン比べる。一致しなければ終了コード 1 で終わる
+//
+// 経路探索のベンチマーク：DungeonWalkingTool.exe --bench-pathfinder
+//   生成マップ上で A* と JPS を比べる。経路長が一致しない探索があれば終了コード 1 で終わる
+//
+// 性能の悪化を確かめるには、Release でビルドしてから TurnBenchmark.bat を実行する
+// （後回しの確認と、基準値との比較を行う。悪化していれば終了コード 1、基準値が無ければ 2）
+// 基準値 TurnBenchmarkBaseline.csv は計測用の1台で TurnBenchmark.bat --record として記録し、コミットしておく
+// 計測用の1台は、ゲートを定期的に走らせるマシン（ハードウェアを変えない専用のもの）にする。
+// p99 はマシンに依存するので、別のマシンの結果とは比べない。計測用のマシンを替えたら記録し直す
+SIV3D_SET(EngineOption::Renderer::Headless)
+
+namespace {
+	// Main を抜けてエンジンの後始末が済んだあとに、プロセスの終了コードとして返す
+	int ExitStatus = EXIT_SUCCESS;
+
+	// 基準値が無く、ベンチマークを比べられなかったときの終了コード
+	constexpr int ExitNoBaseline = 2;
+}
+
+# if SIV3D_PLATFORM(WINDOWS)
+// コンソールアプリ（SubSystem=Console）として起動し、Siv3D のエントリポイントに渡す
+// 端末や CI がプロセスの終了を待ち、標準出力と終了コードを受け取れるようにするため
+int main()
+{
+	const int status = WinMain(::GetModuleHandleW(nullptr), nullptr, ::GetCommandLineA(), SW_HIDE);
+	std::cout.flush();
+	return (status != 0) ? status : ExitStatus;
+}
+# endif
+
+// 1行を標準出力に書く（Siv3D の Console は別ウィンドウを開くので使わない）
+static void Output(const String& line)
+{
+	std::cout << line.toUTF8() << '\n';
+}
+
+// "--name value" 形式の引数を取り出す
+static Optional<String> FindOption(const Array<String>& args, StringView name)
+{
+	for (size_t i = 0; (i + 1) < args.size(); ++i)
+	{
+		if (args[i] == name)
+		{
+			return args[i + 1];
+		}
+	}
+	return none;
+}
+
+// 各フロアでランダムに動くボットにターンを進めさせ、1秒あたりのターン数を表示する
+static void RunSimulationMode(const MapGenBatchOptions& options, int32 turnsPerFloor)
+{
+	constexpr Point Directions[] = {
+		{ 0, -1 }, { 0, 1 }, { -1, 0 }, { 1, 0 },
+		{ -1, -1 }, { 1, -1 }, { -1, 1 }, { 1, 1 }, { 0, 0 },
+	};
+
+	Simulation simulation;
+	DefaultRNG rng{ options.firstSeed };
+	int64 turns = 0;
+	int32 goals = 0;
+	int64 defeated = 0;
+	int64 damageTaken = 0;
+	double elapsedSec = 0.0;
+
+	for (int32 i = 0; i < options.count; ++i)
+	{
+		simulation.load(GenerateFloorPlan(options.config, options.firstSeed + i));
+		if (not simulation.floor().isValid())
+		{
+			continue;
+		}
+
+		// 計るのはターンの処理だけ（生成は含めない）
+		const Stopwatch stopwatch{ StartImmediately::Yes };
+		int32 turn = 0;
+		while (turn < turnsPerFloor)
+		{
+			const TurnResult result = simulation.step(TurnAction{ Directions[Random(0, 8, rng)], true });
+			++turn;
+			defeated += result.enemiesDefeated;
+			damageTaken += result.damageTaken;
+			if (result.reachedGoal)
+			{
+				++goals;
+				break;
+			}
+		}
+		elapsedSec += stopwatch.sF();
+		turns += turn;
+	}
+
+	Output(U"floors: {} / turns: {} in {:.3f} s -> {:.0f} turns/sec"_fmt(options.count, turns, elapsedSec, (elapsedSec > 0.0) ? (turns / elapsedSec) : 0.0));
+	Output(U"goals reached: {} / enemies defeated: {} / damage taken: {}"_fmt(goals, defeated, damageTaken));
+}
+
+// ターン処理のベンチマークを走らせ、基準値と比べる（悪化していたら終了コード 1）
+static void RunTurnBenchmarkMode(const Array<String>& args)
+{
+	TurnBenchmarkOptions options;
+	if (const auto value = FindOption(args, U"--turns")) options.measuredTurns = Max(ParseOr<int32>(*value, options.measuredTurns), 1);
+	options.deferSleepingEnemies = args.includes(U"--defer-sleeping");
+
+	const Array<TurnBenchmarkResult> results = RunTurnBenchmark(options);
+
+	Output(U"map        enemies (placed)    p50 us     p99 us     max us   allocs/turn");
+	for (const auto& result : results)
+	{
+		Output(U"{:>4}x{:<4} {:>7} ({:>6}) {:>9.1f}  {:>9.1f}  {:>9.1f}  {:>10.3f}"_fmt(result.scenario.mapSize, result.scenario.mapSize,
+			result.scenario.enemyCount, result.spawnedEnemies, result.p50Microsec, result.p99Microsec, result.maxMicrosec, result.allocationsPerTurn));
+	}
+
+	if (const auto path = FindOption(args, U"--write-baseline"))
+	{
+		if (not WriteTurnBenchmarkBaseline(*path, results))
+		{
+			Output(U"failed to write {}"_fmt(*path));
+			ExitStatus = EXIT_FAILURE;
+			return;
+		}
+		Output(U"baseline written to {}"_fmt(*path));
+	}
+
+	if (const auto path = FindOption(args, U"--baseline"))
+	{
+		// 基準値がまだ記録されていなければ、悪化とは扱わずに比べなかったことだけ知らせる
+		if (not FileSystem::Exists(*path))
+		{
+			Output(U"WARNING baseline {} not found; record one with --write-baseline on the reference machine"_fmt(*path));
+			ExitStatus = ExitNoBaseline;
+			return;
+		}
+
+		const double tolerance = Max(ParseOr<double>(FindOption(args, U"--tolerance").value_or(U"0.25"), 0.25), 0.0);
+		const Array<String> regressions = CompareTurnBenchmark(*path, results, tolerance);
+		if (not regressions.isEmpty())
+		{
+			for (const auto& regression : regressions)
+			{
+				Output(U"REGRESSION {}"_fmt(regression));
+			}
+			ExitStatus = EXIT_FAILURE;
+			return;
+		}
+		Output(U"no regressions against {}"_fmt(*path));
+	}
+}
+
+// 遠くの敵を後回しにしても同じ結果になるか確かめる（一致しなければ終了コード 1）
+static void RunDeferCheckMode(const Array<String>& args)
+{
+	TurnBenchmarkOptions options;
+	if (const auto value = FindOption(args, U"--turns")) options.measuredTurns = Max(ParseOr<int32>(*value, options.measuredTurns), 1);
+
+	const Array<String> mismatches = CheckDeferredSleepingEnemies(options);
+	if (not mismatches.isEmpty())
+	{
+		for (const auto& mismatch : mismatches)
+		{
+			Output(U"MISMATCH {}"_fmt(mismatch));
+		}
+		ExitStatus = EXIT_FAILURE;
+		return;
+	}
+	Output(U"deferred sleeping enemies match immediate turns");
+}
+
+// A* と JPS を生成マップ上で比較する（経路長が一致しなければ終了コード 1）
+static void RunPathFinderBenchmarkMode()
+{
+	const PathFinderBenchmarkResult result = RunPathFinderBenchmark(200, 200);
+
+	Output(U"maps: {} / queries: {} / found: {}"_fmt(result.mapCount, result.queryCount, result.foundCount));
+	Output(U"A*  : {:.2f} ms ({:.3f} us/query)"_fmt(result.aStarMillisec, result.aStarMillisec * 1000.0 / Max(result.queryCount, 1)));
+	Output(U"JPS : {:.2f} ms ({:.3f} us/query)"_fmt(result.jumpPointMillisec, result.jumpPointMillisec * 1000.0 / Max(result.queryCount, 1)));
+	Output(U"length mismatches: {}"_fmt(result.lengthMismatches));
+
+	if (result.lengthMismatches != 0)
+	{
+		ExitStatus = EXIT_FAILURE;
+	}
+}
+
+void Main()
+{
+	const Array<String> args = System::GetCommandLineArgs();
+
+	if (args.includes(U"--bench-pathfinder"))
+	{
+		RunPathFinderBenchmarkMode();
+		return;
+	}
+
+	if (args.includes(U"--check-defer"))
+	{
+		RunDeferCheckMode(args);
+		return;
+	}
+
+	if (args.includes(U"--bench-turns"))
+	{
+		RunTurnBenchmarkMode(args);
+		return;
+	}
+
+	MapGenBatchOptions options;
+	if (const auto value = FindOption(args, U"--count")) options.count = ParseOr<int32>(*value, options.count);
+	if (const auto value = FindOption(args, U"--seed")) options.firstSeed = ParseOr<uint64>(*value, options.firstSeed);
+	if (const auto value = FindOption(args, U"--threads")) options.threads = ParseOr<int32>(*value, options.threads);
+	if (const auto value = FindOption(args, U"--mini")) options.config.miniSize = ParseOr<int32>(*value, options.config.miniSize);
+	if (const auto value = FindOption(args, U"--unit")) options.config.roomUnit = ParseOr<int32>(*value, options.config.roomUnit);
+	// 生成器と同じ範囲に収めておく（表示や書き出すヘッダの値を実際の大きさと揃える）
+	options.config = MapGenerator::ClampConfig(options.config);
+	if (const auto value = FindOption(args, U"--dump")) options.dumpPath = *value;
+
+	if (const auto value = FindOption(args, U"--sim-turns"))
+	{
+		RunSimulationMode(options, Max(ParseOr<int32>(*value, 1000), 1));
+		return;
+	}
+
+	const MapGenBatchResult result = RunMapGenBatch(options);
+
+	Output(U"map size: {0}x{0} (minimap {1}x{1}, room unit {2})"_fmt(options.config.mapSize(), options.config.miniSize, options.config.roomUnit));
+	Output(U"seeds: {} - {}"_fmt(options.firstSeed, options.firstSeed + Max(result.mapCount - 1, 0)));
+	Output(U"maps: {} (failed: {}) in {:.3f} s -> {:.1f} maps/sec"_fmt(result.mapCount, result.failedCount, result.elapsedSec, result.mapsPerSec));
+	Output(U"repair corridors / map: min {} / avg {:.2f} / max {}"_fmt(result.repairMin, static_cast<double>(result.repairTotal) / Max(result.mapCount, 1), result.repairMax));
+
+	Output(U"room count distribution:");
+	for (size_t rooms = 0; rooms < result.roomHistogram.size(); ++rooms)
+	{
+		if (result.roomHistogram[rooms] != 0)
+		{
+			Output(U"  {:>4} rooms: {:>7} ({:.1f}%)"_fmt(rooms, result.roomHistogram[rooms], 100.0 * result.roomHistogram[rooms] / Max(result.mapCount, 1)));
+		}
+	}
+
+	if (not options.dumpPath.isEmpty())
+	{
+		Output(result.dumpWritten ? U"dumped to {}"_fmt(options.dumpPath) : U"failed to write {}"_fmt(options.dumpPath));
+	}
+
+	if ((result.failedCount != 0) || (not options.dumpPath.isEmpty() && not result.dumpWritten))
+	{
+		ExitStatus = EXIT_FAILURE;
+	}
+}
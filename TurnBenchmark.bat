@@ -0,0 +1,16 @@
+@echo off
+rem Turn benchmark regression gate. Build DungeonWalkingTool (Release) first.
+rem   TurnBenchmark.bat          check deferred enemies, then compare against TurnBenchmarkBaseline.csv
+rem                              exit code 0: ok, 1: mismatch or regression, 2: no baseline recorded yet (warning)
+rem   TurnBenchmark.bat --record record TurnBenchmarkBaseline.csv on the reference machine
+setlocal
+pushd "%~dp0App"
+if "%~1"=="--record" (
+	DungeonWalkingTool.exe --bench-turns --write-baseline "%~dp0TurnBenchmarkBaseline.csv"
+) else (
+	DungeonWalkingTool.exe --check-defer
+	if not errorlevel 1 DungeonWalkingTool.exe --bench-turns --baseline "%~dp0TurnBenchmarkBaseline.csv"
+)
+set STATUS=%ERRORLEVEL%
+popd
+exit /b %STATUS%
@@ -0,0 +1,230 @@
+﻿
+#include "TurnBenchmark.hpp"
+#include "Simulation.hpp"
+#include "MapGenerator.hpp"
+#include "AllocationCounter.hpp"
+
+namespace {
+	constexpr Point Directions[] = {
+		{ 0, -1 }, { 0, 1 }, { -1, 0 }, { 1, 0 },
+		{ -1, -1 }, { 1, -1 }, { -1, 1 }, { 1, 1 }, { 0, 0 },
+	};
+
+	// 昇順に並んだ値の p パーセンタイル（最近傍）
+	double Percentile(const Array<double>& sorted, double p) {
+		if (sorted.isEmpty()) return 0.0;
+		const size_t index = Min(static_cast<size_t>(p / 100.0 * sorted.size()), sorted.size() - 1);
+		return sorted[index];
+	}
+
+	// 生成した階の敵の配置を、床からランダムに選んだ count マスに置き換える（スタートとゴールは避ける）
+	int32 PlaceEnemies(FloorPlan& plan, int32 count, DefaultRNG& rng) {
+		Array<Point> floorTiles;
+		for (int32 y = 0; y < static_cast<int32>(plan.tiles.height()); ++y) {
+			for (int32 x = 0; x < static_cast<int32>(plan.tiles.width()); ++x) {
+				const Point p{ x, y };
+				if (IsPassable(plan.tiles[p]) && (p != plan.start) && (p != plan.goal)) {
+					floorTiles << p;
+				}
+			}
+		}
+		floorTiles.shuffle(rng);
+
+		// 敵で埋め尽くさないよう、床の半分までにする
+		const size_t placed = Min(static_cast<size_t>(Max(count, 0)), floorTiles.size() / 2);
+		plan.enemySpawns.assign(floorTiles.begin(), floorTiles.begin() + placed);
+		return static_cast<int32>(placed);
+	}
+
+	// 眠っている敵が行動した延べ数と、プレイヤーと全ての敵の位置・HP が一致するか
+	// （巡回地点で止まっている敵は動かないので、行動を飛ばしたことは位置よりも延べ数に現れる）
+	bool SameState(const Simulation& a, const Simulation& b) {
+		if (a.sleepingEnemyActions() != b.sleepingEnemyActions()) return false;
+		if ((a.player().GetPlayerPos() != b.player().GetPlayerPos()) || (a.player().GetSterts().HP != b.player().GetSterts().HP)) return false;
+		if (a.enemies().size() != b.enemies().size()) return false;
+		for (size_t i = 0; i < a.enemies().size(); ++i) {
+			if ((a.enemies().position(i) != b.enemies().position(i)) || (a.enemies().hp(i) != b.enemies().hp(i))) return false;
+		}
+		return true;
+	}
+
+	String ScenarioKey(const TurnBenchmarkScenario& scenario) {
+		return U"{}x{}/{}"_fmt(scenario.mapSize, scenario.mapSize, scenario.enemyCount);
+	}
+}
+
+Array<TurnBenchmarkScenario> DefaultTurnBenchmarkScenarios() {
+	Array<TurnBenchmarkScenario> scenarios;
+	for (const int32 mapSize : { 50, 200, 1000 }) {
+		for (const int32 enemyCount : { 10, 100, 1000, 10000 }) {
+			scenarios << TurnBenchmarkScenario{ mapSize, enemyCount };
+		}
+	}
+	return scenarios;
+}
+
+Array<TurnBenchmarkResult> RunTurnBenchmark(const TurnBenchmarkOptions& options) {
+	const Array<TurnBenchmarkScenario> scenarios = options.scenarios.isEmpty() ? DefaultTurnBenchmarkScenarios() : options.scenarios;
+
+	Array<TurnBenchmarkResult> results;
+	Simulation simulation;
+	Array<double> samples;
+
+	for (const auto& scenario : scenarios) {
+		TurnBenchmarkResult result;
+		result.scenario = scenario;
+
+		// 同じ条件なら毎回同じマップ・配置・行動になるよう、シードを固定する
+		const MapConfig config{ Max(scenario.mapSize / TurnBenchmarkRoomUnit, 2), TurnBenchmarkRoomUnit };
+		DefaultRNG rng{ options.seed };
+		FloorPlan plan = GenerateFloorPlan(config, MapGenerator::FloorSeed(options.seed, scenario.mapSize));
+		if (!plan.isValid()) {
+			results << result;
+			continue;
+		}
+		result.spawnedEnemies = PlaceEnemies(plan, scenario.enemyCount, rng);
+		simulation.setDeferSleepingEnemies(options.deferSleepingEnemies);
+		simulation.load(std::move(plan));
+
+		// ゴールに着いたら同じ階を最初からやり直す（敵の数を保つため）
+		const auto stepOnce = [&]() {
+			if (simulation.step(TurnAction{ Directions[Random(0, 8, rng)], true }).reachedGoal) {
+				FloorPlan replay = simulation.floor();
+				simulation.load(std::move(replay));
+				return false;
+			}
+			return true;
+		};
+
+		for (int32 turn = 0; turn < options.warmupTurns; ++turn) {
+			stepOnce();
+			simulation.updateSleepingEnemies();
+		}
+
+		samples.clear();
+		samples.reserve(options.measuredTurns);
+		uint64 allocations = 0;
+		Stopwatch stopwatch;
+		for (int32 turn = 0; turn < options.measuredTurns; ++turn) {
+			const uint64 allocationsBefore = AllocationCounter::Count();
+			stopwatch.restart();
+			const bool counted = stepOnce();
+			const double elapsed = stopwatch.usF();
+			// 後回しにした敵は次の入力までのフレームで動く分なので、時間には含めない（確保回数には含める）
+			simulation.updateSleepingEnemies();
+			// やり直しの読み込みはターンの処理ではないので数えない
+			if (counted) {
+				allocations += (AllocationCounter::Count() - allocationsBefore);
+				samples << elapsed;
+			}
+		}
+
+		samples.sort();
+		result.turnCount = static_cast<int32>(samples.size());
+		result.p50Microsec = Percentile(samples, 50.0);
+		result.p99Microsec = Percentile(samples, 99.0);
+		result.maxMicrosec = samples.isEmpty() ? 0.0 : samples.back();
+		result.allocationsPerTurn = static_cast<double>(allocations) / Max(result.turnCount, 1);
+		results << result;
+	}
+
+	return results;
+}
+
+bool WriteTurnBenchmarkBaseline(FilePathView path, const Array<TurnBenchmarkResult>& results) {
+	TextWriter writer{ path };
+	if (!writer) return false;
+
+	writer << U"map_size,enemies,p50_us,p99_us,allocations_per_turn";
+	for (const auto& result : results) {
+		writer << U"{},{},{:.3f},{:.3f},{:.3f}"_fmt(result.scenario.mapSize, result.scenario.enemyCount,
+			result.p50Microsec, result.p99Microsec, result.allocationsPerTurn);
+	}
+	return true;
+}
+
+Array<String> CompareTurnBenchmark(FilePathView baselinePath, const Array<TurnBenchmarkResult>& results, double tolerance) {
+	Array<String> regressions;
+
+	const CSV csv{ baselinePath };
+	if (!csv) {
+		regressions << U"cannot read baseline {} (record one with --write-baseline on the reference machine)"_fmt(baselinePath);
+		return regressions;
+	}
+
+	for (const auto& result : results) {
+		// 同じ条件の行を探す（1行目は見出し）
+		bool found = false;
+		for (size_t row = 1; row < csv.rows(); ++row) {
+			if (csv.columns(row) < 5) continue;
+			if ((ParseOr<int32>(csv[row][0], -1) != result.scenario.mapSize) || (ParseOr<int32>(csv[row][1], -1) != result.scenario.enemyCount)) continue;
+
+			found = true;
+			const double baseP99 = ParseOr<double>(csv[row][3], 0.0);
+			const double baseAllocations = ParseOr<double>(csv[row][4], 0.0);
+			if (result.p99Microsec > baseP99 * (1.0 + tolerance)) {
+				regressions << U"{}: p99 {:.1f} us > baseline {:.1f} us (+{:.0f}%)"_fmt(ScenarioKey(result.scenario), result.p99Microsec, baseP99, tolerance * 100.0);
+			}
+			if (result.allocationsPerTurn > baseAllocations + 0.001) {
+				regressions << U"{}: {:.3f} allocations/turn > baseline {:.3f}"_fmt(ScenarioKey(result.scenario), result.allocationsPerTurn, baseAllocations);
+			}
+			break;
+		}
+		if (!found) {
+			regressions << U"{}: no baseline entry"_fmt(ScenarioKey(result.scenario));
+		}
+	}
+	return regressions;
+}
+
+Array<String> CheckDeferredSleepingEnemies(const TurnBenchmarkOptions& options) {
+	const Array<TurnBenchmarkScenario> scenarios = options.scenarios.isEmpty() ? DefaultTurnBenchmarkScenarios() : options.scenarios;
+	const int32 turnCount = options.warmupTurns + options.measuredTurns;
+
+	Array<String> mismatches;
+	Simulation immediate;
+	Simulation deferred;
+	immediate.setDeferSleepingEnemies(false);
+	deferred.setDeferSleepingEnemies(true);
+
+	for (const auto& scenario : scenarios) {
+		// RunTurnBenchmark と同じマップ・配置・行動にする
+		const MapConfig config{ Max(scenario.mapSize / TurnBenchmarkRoomUnit, 2), TurnBenchmarkRoomUnit };
+		DefaultRNG rng{ options.seed };
+		FloorPlan plan = GenerateFloorPlan(config, MapGenerator::FloorSeed(options.seed, scenario.mapSize));
+		if (!plan.isValid()) continue;
+		PlaceEnemies(plan, scenario.enemyCount, rng);
+		immediate.load(plan);
+		deferred.load(std::move(plan));
+
+		for (int32 turn = 0; turn < turnCount; ++turn) {
+			const TurnAction action{ Directions[Random(0, 8, rng)], true };
+			const TurnResult a = immediate.step(action);
+			const TurnResult b = deferred.step(action);
+			if ((a.reachedGoal != b.reachedGoal) || (a.damageTaken != b.damageTaken) || (a.enemiesDefeated != b.enemiesDefeated) || (a.bumpedEnemy != b.bumpedEnemy)) {
+				mismatches << U"{}: turn {} results differ"_fmt(ScenarioKey(scenario), turn);
+				break;
+			}
+			if (a.reachedGoal) {
+				FloorPlan replay = immediate.floor();
+				immediate.load(replay);
+				deferred.load(std::move(replay));
+				continue;
+			}
+
+			// フレームごとに少しずつ進める様子をまねて、1体ずつしか進めない予算で数回だけ呼ぶ
+			for (int32 frame = 0; frame < 3; ++frame) {
+				deferred.updateSleepingEnemies(Duration{ 0 });
+			}
+			// 1ターンおきに残りを全て行動させて比べる（残りのターンは次の step の最初で行動する）
+			if (turn % 2 == 1) {
+				deferred.updateSleepingEnemies();
+				if (!SameState(immediate, deferred)) {
+					mismatches << U"{}: turn {} state differs"_fmt(ScenarioKey(scenario), turn);
+					break;
+				}
+			}
+		}
+	}
+	return mismatches;
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+# include "Common.hpp"
+
+// ターン処理のベンチマークの1条件
+struct TurnBenchmarkScenario {
+	int32 mapSize = 50;       // マップの一辺（部屋の一辺 TurnBenchmarkRoomUnit の倍数）
+	int32 enemyCount = 10;    // 置く敵の数（床が足りなければ床の半分まで）
+};
+
+// ベンチマークの設定
+struct TurnBenchmarkOptions {
+	uint64 seed = 20240601;   // マップ・敵の配置・プレイヤーの行動を決めるシード
+	int32 warmupTurns = 20;   // 計測前に進めるターン数（作業領域の確保を済ませる）
+	int32 measuredTurns = 200;
+	// 遠くの敵を後回しにして、step（入力に対する処理）だけの時間を測る。後回しにした敵は計測の外で毎ターン全て動かす
+	bool deferSleepingEnemies = false;
+	Array<TurnBenchmarkScenario> scenarios;  // 空なら既定の条件（50/200/1000 マス × 敵 10〜10000 体）
+};
+
+// 1条件の結果
+struct TurnBenchmarkResult {
+	TurnBenchmarkScenario scenario;
+	int32 spawnedEnemies = 0;      // 実際に置いた敵の数
+	int32 turnCount = 0;           // 計測したターン数
+	double p50Microsec = 0.0;      // 1ターンの処理時間の中央値
+	double p99Microsec = 0.0;      // 1ターンの処理時間の 99 パーセンタイル
+	double maxMicrosec = 0.0;
+	double allocationsPerTurn = 0.0;  // 1ターンあたりのヒープ確保回数
+};
+
+constexpr int32 TurnBenchmarkRoomUnit = 10;
+
+// 既定の条件
+Array<TurnBenchmarkScenario> DefaultTurnBenchmarkScenarios();
+
+// 各条件で Simulation::step（プレイヤーの移動・攻撃、倒した敵の片付け、敵の索敵と経路探索）を繰り返し、1ターンの処理時間を測る
+// プレイヤーはシードで決まるランダムな方向に動くので、同じ設定なら同じ手順になる
+Array<TurnBenchmarkResult> RunTurnBenchmark(const TurnBenchmarkOptions& options);
+
+// 結果を基準値として CSV に書き出す
+bool WriteTurnBenchmarkBaseline(FilePathView path, const Array<TurnBenchmarkResult>& results);
+
+// 基準値の CSV と比べ、悪化した条件を説明する文を返す（空なら合格）
+// p99 が基準値の (1 + tolerance) 倍を超えるか、1ターンあたりの確保回数が基準値より増えたら悪化とみなす
+Array<String> CompareTurnBenchmark(FilePathView baselinePath, const Array<TurnBenchmarkResult>& results, double tolerance);
+
+// 同じシード・同じ行動で、遠くの敵を後回しにする場合としない場合のターンを進め、結果とプレイヤー・全ての敵の位置・HP、眠っている敵が行動した延べ数が一致するか確かめる
+// 後回しにする側は、フレームの予算を使い切った場合をまねて一部の敵を次の step まで残す
+// 一致しなかった条件を説明する文を返す（空なら合格）
+Array<String> CheckDeferredSleepingEnemies(const TurnBenchmarkOptions& options);
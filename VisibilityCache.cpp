@@ -0,0 +1,72 @@
+﻿
+#include "VisibilityCache.hpp"
+
+namespace {
+	// from から to へ整数のブレゼンハム線を引き、間のマス（両端は除く）に視線を遮るマスもマップ外もなければ true
+	bool TraceClear(Point from, Point to, const TileGrid& tiles) {
+		const int32 dx = Abs(to.x - from.x);
+		const int32 dy = -Abs(to.y - from.y);
+		const int32 sx = (from.x < to.x) ? 1 : -1;
+		const int32 sy = (from.y < to.y) ? 1 : -1;
+		int32 err = dx + dy;
+
+		Point p = from;
+		while (p != to) {
+			const int32 e2 = err * 2;
+			if (e2 >= dy) { err += dy; p.x += sx; }
+			if (e2 <= dx) { err += dx; p.y += sy; }
+
+			if (p == to) break;
+			if (!tiles.inBounds(p) || BlocksSight(tiles[p])) return false;
+		}
+		return true;
+	}
+}
+
+bool HasLineOfSight(Point a, Point b, const TileGrid& tiles) {
+	return TraceClear(a, b, tiles) || TraceClear(b, a, tiles);
+}
+
+void VisibilityCache::clear() {
+	m_mapSize = Size{ 0, 0 };
+	m_bits.clear();
+}
+
+void VisibilityCache::set(Point from, Point d) {
+	const size_t bit = BitIndex(d);
+	m_bits[wordIndex(from) + (bit / 64)] |= (uint64{ 1 } << (bit % 64));
+}
+
+void VisibilityCache::build(const TileGrid& tiles) {
+	m_mapSize = tiles.size();
+	m_bits.assign(static_cast<size_t>(m_mapSize.x) * m_mapSize.y * WordsPerTile, 0);
+
+	// 距離が SightRange 以内（切り捨て）のずれのうち、片側半分だけ（残りは対称性で埋める）
+	Array<Point> offsets;
+	for (int32 y = 0; y <= SightRange; ++y) {
+		for (int32 x = -SightRange; x <= SightRange; ++x) {
+			if ((y == 0) && (x <= 0)) continue;
+			if (((x * x) + (y * y)) < ((SightRange + 1) * (SightRange + 1))) {
+				offsets << Point{ x, y };
+			}
+		}
+	}
+
+	for (int32 y = 0; y < m_mapSize.y; ++y) {
+		for (int32 x = 0; x < m_mapSize.x; ++x) {
+			const Point from{ x, y };
+			if (!IsPassable(tiles[from])) continue;
+
+			set(from, Point{ 0, 0 });
+			for (const auto& d : offsets) {
+				const Point to = from + d;
+				if (!tiles.inBounds(to) || !IsPassable(tiles[to])) continue;
+
+				if (HasLineOfSight(from, to, tiles)) {
+					set(from, d);
+					set(to, -d);
+				}
+			}
+		}
+	}
+}
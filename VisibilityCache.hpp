@@ -0,0 +1,43 @@
+﻿#pragma once
+# include "Common.hpp"
+# include "Tile.hpp"
+
+// a から b が見えるか（整数のブレゼンハム線で、両端を除くマスに視線を遮るマスがなければ見える）
+// a→b と b→a の両方向を引いてどちらかが通れば見えるとするので、HasLineOfSight(a, b) == HasLineOfSight(b, a) になる
+bool HasLineOfSight(Point a, Point b, const TileGrid& tiles);
+
+// 階ごとの視界表
+// 地形は階の途中で変わらないので、生成した直後に「各マスから半径 SightRange 以内のどのマスが見えるか」を
+// マスごとのビット列にまとめておき、敵の索敵はビットを1つ調べるだけにする。
+// 見え方は対称（敵からプレイヤーが見えるなら、プレイヤーからも敵が見える）。
+class VisibilityCache {
+public:
+	static constexpr int32 SightRange = 4;  // 見える距離（マス。ユークリッド距離を切り捨てて比べる）
+
+	// tiles の全ての通れるマスについて視界を求める
+	void build(const TileGrid& tiles);
+	void clear();
+
+	// build した地形と同じ大きさか
+	bool isBuiltFor(Size mapSize) const { return (m_mapSize == mapSize) && !m_bits.isEmpty(); }
+
+	// from から to が見えるか（SightRange より遠い・壁・マップ外なら false）
+	bool canSee(Point from, Point to) const {
+		const Point d = to - from;
+		if (!InRange(d.x, -SightRange, SightRange) || !InRange(d.y, -SightRange, SightRange)) return false;
+		if (!InRange(from.x, 0, m_mapSize.x - 1) || !InRange(from.y, 0, m_mapSize.y - 1)) return false;
+		const size_t bit = BitIndex(d);
+		return ((m_bits[wordIndex(from) + (bit / 64)] >> (bit % 64)) & 1) != 0;
+	}
+
+private:
+	static constexpr int32 WindowSize = (SightRange * 2) + 1;
+	static constexpr size_t WordsPerTile = ((WindowSize * WindowSize) + 63) / 64;
+
+	static constexpr size_t BitIndex(Point d) { return static_cast<size_t>(((d.y + SightRange) * WindowSize) + (d.x + SightRange)); }
+	size_t wordIndex(Point p) const { return ((static_cast<size_t>(p.y) * m_mapSize.x) + p.x) * WordsPerTile; }
+	void set(Point from, Point d);
+
+	Size m_mapSize{ 0, 0 };
+	Array<uint64> m_bits;  // マスごとに WordsPerTile 個。視界の窓（WindowSize × WindowSize）の1マスが1ビット
+};
@@ -0,0 +1,217 @@
+﻿
+#include "WalkableBitboard.hpp"
+#include <bit>
+
+namespace {
+	// 行全体を1マス右（x が大きい方）へずらした i 番目の語
+	uint64 ShiftedRight(const uint64* words, int32 i) {
+		return (words[i] << 1) | ((i > 0) ? (words[i - 1] >> 63) : 0);
+	}
+
+	// 行全体を1マス左（x が小さい方）へずらした i 番目の語
+	uint64 ShiftedLeft(const uint64* words, int32 i, int32 wordCount) {
+		return (words[i] >> 1) | ((i + 1 < wordCount) ? (words[i + 1] << 63) : 0);
+	}
+
+	// 到達マスを、通れるマスの並びに沿って x の大きい方へ並びの端まで一度に伸ばす（変わったら true）
+	// 並びに到達マスを足すと、繰り上がりがその並びの右端まで伝わって並びのビットを 0 にする
+	// （walkable & ~和 が伸ばした範囲。語をまたぐ並びには繰り上がりを次の語へ渡す）
+	bool FillRight(uint64* reached, const uint64* walkable, int32 wordCount) {
+		bool changed = false;
+		uint64 carry = 0;
+		for (int32 i = 0; i < wordCount; ++i) {
+			const uint64 seeds = reached[i];
+			const uint64 partial = walkable[i] + seeds;
+			const uint64 sum = partial + carry;
+			carry = ((partial < walkable[i]) || (sum < partial)) ? 1 : 0;
+
+			const uint64 next = (walkable[i] & ~sum) | seeds;
+			changed |= (next != seeds);
+			reached[i] = next;
+		}
+		return changed;
+	}
+
+	uint64 ReverseBits(uint64 x) {
+		x = ((x >> 1) & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+		x = ((x >> 2) & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+		x = ((x >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((x & 0x0F0F0F0F0F0F0F0Full) << 4);
+		x = ((x >> 8) & 0x00FF00FF00FF00FFull) | ((x & 0x00FF00FF00FF00FFull) << 8);
+		x = ((x >> 16) & 0x0000FFFF0000FFFFull) | ((x & 0x0000FFFF0000FFFFull) << 16);
+		return (x >> 32) | (x << 32);
+	}
+
+	// x の小さい方へ伸ばす（行を左右反転して FillRight をかけ、元に戻す）
+	bool FillLeft(uint64* reached, const uint64* walkable, int32 wordCount, uint64* reversedReached, uint64* reversedWalkable) {
+		for (int32 i = 0; i < wordCount; ++i) {
+			reversedReached[i] = ReverseBits(reached[wordCount - 1 - i]);
+			reversedWalkable[i] = ReverseBits(walkable[wordCount - 1 - i]);
+		}
+		if (!FillRight(reversedReached, reversedWalkable, wordCount)) return false;
+
+		for (int32 i = 0; i < wordCount; ++i) {
+			reached[wordCount - 1 - i] = ReverseBits(reversedReached[i]);
+		}
+		return true;
+	}
+
+	// x - 1, x, x + 1 の3マスのビット（ビット 0 が x - 1。マップの外は 0）
+	uint32 ThreeBits(const uint64* words, int32 x, int32 width) {
+		uint32 bits = 0;
+		for (int32 i = 0; i < 3; ++i) {
+			const int32 cx = x - 1 + i;
+			if (InRange(cx, 0, width - 1) && ((words[cx / 64] >> (cx % 64)) & 1)) {
+				bits |= (1u << i);
+			}
+		}
+		return bits;
+	}
+}
+
+void WalkableBitboard::assign(Size size) {
+	m_size = size;
+	m_wordsPerRow = (size.x + 63) / 64;
+	m_words.assign(static_cast<size_t>(m_wordsPerRow) * size.y, 0);
+}
+
+void WalkableBitboard::build(const TileGrid& tiles) {
+	assign(tiles.size());
+	for (int32 y = 0; y < m_size.y; ++y) {
+		uint64* words = row(y);
+		for (int32 x = 0; x < m_size.x; ++x) {
+			if (IsPassable(tiles[y][x])) {
+				words[x / 64] |= (uint64{ 1 } << (x % 64));
+			}
+		}
+	}
+}
+
+void WalkableBitboard::set(Point p, bool walkable) {
+	if (!InRange(p.x, 0, m_size.x - 1) || !InRange(p.y, 0, m_size.y - 1)) return;
+
+	const uint64 bit = (uint64{ 1 } << (p.x % 64));
+	uint64& word = row(p.y)[p.x / 64];
+	word = walkable ? (word | bit) : (word & ~bit);
+}
+
+uint8 WalkableBitboard::neighborMask(Point p) const {
+	// 上・同じ・下の行から3マスずつ取り出し、Directions の並びに組み替える
+	const uint32 above = (p.y > 0) ? ThreeBits(row(p.y - 1), p.x, m_size.x) : 0;
+	const uint32 middle = InRange(p.y, 0, m_size.y - 1) ? ThreeBits(row(p.y), p.x, m_size.x) : 0;
+	const uint32 below = (p.y + 1 < m_size.y) ? ThreeBits(row(p.y + 1), p.x, m_size.x) : 0;
+
+	return static_cast<uint8>(
+		(((above >> 1) & 1) << 0)      // 上
+		| (((below >> 1) & 1) << 1)    // 下
+		| (((middle >> 0) & 1) << 2)   // 左
+		| (((middle >> 2) & 1) << 3)   // 右
+		| (((above >> 0) & 1) << 4)    // 左上
+		| (((above >> 2) & 1) << 5)    // 右上
+		| (((below >> 0) & 1) << 6)    // 左下
+		| (((below >> 2) & 1) << 7));  // 右下
+}
+
+size_t WalkableBitboard::count() const {
+	size_t total = 0;
+	for (const uint64 word : m_words) {
+		total += std::popcount(word);
+	}
+	return total;
+}
+
+uint64 WalkableBitboard::RangeMask(int32 word, int32 x0, int32 x1) {
+	const int32 begin = Clamp(x0 - (word * 64), 0, 64);
+	const int32 end = Clamp(x1 - (word * 64), 0, 64);
+	if (begin >= end) return 0;
+
+	const uint64 upTo = (end == 64) ? ~uint64{ 0 } : ((uint64{ 1 } << end) - 1);
+	return upTo & ~((uint64{ 1 } << begin) - 1);
+}
+
+size_t WalkableBitboard::count(const Rect& rect) const {
+	const int32 x0 = Max(rect.x, 0), x1 = Min(rect.x + rect.w, m_size.x);
+	const int32 y0 = Max(rect.y, 0), y1 = Min(rect.y + rect.h, m_size.y);
+	if (x0 >= x1) return 0;
+
+	size_t total = 0;
+	for (int32 y = y0; y < y1; ++y) {
+		const uint64* words = row(y);
+		for (int32 i = x0 / 64; i <= (x1 - 1) / 64; ++i) {
+			total += std::popcount(words[i] & RangeMask(i, x0, x1));
+		}
+	}
+	return total;
+}
+
+Optional<Point> WalkableBitboard::nth(const Rect& rect, size_t n) const {
+	const int32 x0 = Max(rect.x, 0), x1 = Min(rect.x + rect.w, m_size.x);
+	const int32 y0 = Max(rect.y, 0), y1 = Min(rect.y + rect.h, m_size.y);
+	if (x0 >= x1) return none;
+
+	for (int32 y = y0; y < y1; ++y) {
+		const uint64* words = row(y);
+		for (int32 i = x0 / 64; i <= (x1 - 1) / 64; ++i) {
+			uint64 bits = words[i] & RangeMask(i, x0, x1);
+			const size_t bitCount = std::popcount(bits);
+			if (n >= bitCount) {
+				n -= bitCount; // この語には無いので、数だけ進める
+				continue;
+			}
+			for (; n > 0; --n) {
+				bits &= (bits - 1); // 下位から n 個を消す
+			}
+			return Point{ (i * 64) + std::countr_zero(bits), y };
+		}
+	}
+	return none;
+}
+
+WalkableBitboard WalkableBitboard::floodFill(Point seed) const {
+	WalkableBitboard reached;
+	reached.assign(m_size);
+	if (!isWalkable(seed)) return reached;
+	reached.set(seed, true);
+
+	// 上から下、下から上へ交互に行を掃き、広がらなくなるまで繰り返す。
+	// 各行では、隣の行の到達マスを斜めも含めて3マス幅に広げて取り込み、行の中を左右へ広げきる。
+	// 左右へは足し算の繰り上がりで並びの端まで一度に伸ばすので、長い通路でも1マスずつ繰り返さない。
+	Array<uint64> spread(m_wordsPerRow, 0);
+	Array<uint64> reversedReached(m_wordsPerRow, 0);
+	Array<uint64> reversedWalkable(m_wordsPerRow, 0);
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (const int32 step : { 1, -1 }) {
+			const int32 first = (step > 0) ? 0 : (m_size.y - 1);
+			for (int32 y = first; InRange(y, 0, m_size.y - 1); y += step) {
+				const uint64* walkable = row(y);
+				uint64* current = reached.row(y);
+
+				const int32 prevY = y - step;
+				if (InRange(prevY, 0, m_size.y - 1)) {
+					const uint64* prev = reached.row(prevY);
+					for (int32 i = 0; i < m_wordsPerRow; ++i) {
+						spread[i] = prev[i] | ShiftedRight(prev, i) | ShiftedLeft(prev, i, m_wordsPerRow);
+					}
+				}
+				else {
+					spread.fill(0);
+				}
+
+				bool rowChanged = false;
+				for (int32 i = 0; i < m_wordsPerRow; ++i) {
+					const uint64 next = current[i] | (spread[i] & walkable[i]);
+					rowChanged |= (next != current[i]);
+					current[i] = next;
+				}
+
+				// 行の中で左右に広げる（到達マスを含む通れるマスの並びを、語ごとに一度で端まで埋める）
+				rowChanged |= FillRight(current, walkable, m_wordsPerRow);
+				rowChanged |= FillLeft(current, walkable, m_wordsPerRow, reversedReached.data(), reversedWalkable.data());
+
+				changed |= rowChanged;
+			}
+		}
+	}
+	return reached;
+}
@@ -0,0 +1,53 @@
+﻿#pragma once
+# include "Common.hpp"
+# include "Tile.hpp"
+
+// 通れるマスの表（1マス1ビット、1行を64マスずつの uint64 に詰める）
+// 地形（TileGrid、1マス1バイト）とは別に、階の生成時に一緒に作って持つ。
+// 塗りつぶし・数え上げ・周囲8マスの判定を、1マスずつの分岐ではなく64マスずつのビット演算で行う。
+class WalkableBitboard {
+public:
+	// neighborMask のビットの並び（ビット i が Directions[i] の方向。直線を先に並べる）
+	static constexpr Point Directions[] = {
+		{ 0, -1 }, { 0, 1 }, { -1, 0 }, { 1, 0 },
+		{ -1, -1 }, { 1, -1 }, { -1, 1 }, { 1, 1 },
+	};
+
+	// tiles の通れる種類（IsPassable）のマスを通れるマスにする
+	void build(const TileGrid& tiles);
+	// 全て通れない表にする
+	void assign(Size size);
+
+	Size size() const { return m_size; }
+	bool isEmpty() const { return m_words.isEmpty(); }
+
+	bool isWalkable(Point p) const {
+		if (!InRange(p.x, 0, m_size.x - 1) || !InRange(p.y, 0, m_size.y - 1)) return false;
+		return ((row(p.y)[p.x / 64] >> (p.x % 64)) & 1) != 0;
+	}
+	void set(Point p, bool walkable);
+
+	// p の周囲8マスのうち通れるマス（ビット i が Directions[i]。マップの外は通れない）
+	uint8 neighborMask(Point p) const;
+
+	// 通れるマスの数
+	size_t count() const;
+	// rect 内の通れるマスの数
+	size_t count(const Rect& rect) const;
+	// rect 内の通れるマスのうち、左上から数えて n 番目（0から）のマス
+	Optional<Point> nth(const Rect& rect, size_t n) const;
+
+	// seed から8方向に歩いて行けるマスの表（seed が通れなければ空の表）
+	WalkableBitboard floodFill(Point seed) const;
+
+private:
+	uint64* row(int32 y) { return m_words.data() + (static_cast<size_t>(y) * m_wordsPerRow); }
+	const uint64* row(int32 y) const { return m_words.data() + (static_cast<size_t>(y) * m_wordsPerRow); }
+
+	// 行のうち x0 <= x < x1 の範囲にあたる、word 番目の語のマスク
+	static uint64 RangeMask(int32 word, int32 x0, int32 x1);
+
+	Size m_size{ 0, 0 };
+	int32 m_wordsPerRow = 0;
+	Array<uint64> m_words;   // 行ごとに m_wordsPerRow 語。幅を超えたビットは常に 0
+};